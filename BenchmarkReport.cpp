@@ -0,0 +1,163 @@
+#include "BenchmarkReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+TimingStatistics compute_timing_statistics(std::vector<float> times)
+{
+	if (times.empty())
+	{
+		throw std::runtime_error("Can't compute the statistics of zero runs");
+	}
+	std::sort(times.begin(), times.end());
+
+	TimingStatistics statistics;
+	size_t count = times.size();
+	statistics.min = times.front();
+	statistics.median = count % 2 == 1 ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) / 2.0f;
+	size_t p99_rank = static_cast<size_t>(std::ceil(0.99 * count));
+	statistics.p99 = times[std::max<size_t>(p99_rank, 1) - 1];
+	return statistics;
+}
+
+double BenchmarkResult::mpixels_per_second() const
+{
+	double pixel_count = static_cast<double>(width) * height;
+	return pixel_count / (std::max(time.median, 0.001f) * 1000.0);
+}
+
+double BenchmarkResult::gigabytes_per_second() const
+{
+	double bytes = 2.0 * width * height * (num_of_bits / 8);
+	return bytes / (std::max(time.median, 0.001f) * 1.0e6);
+}
+
+// Quote a string for JSON. The names only need the quotes and backslashes escaped
+static std::string json_string(const std::string& text)
+{
+	std::string quoted = "\"";
+	for (char character : text)
+	{
+		if (character == '"' || character == '\\')
+		{
+			quoted += '\\';
+		}
+		quoted += character;
+	}
+	return quoted + "\"";
+}
+
+// Quote a string for CSV, doubling the quotes inside it
+static std::string csv_string(const std::string& text)
+{
+	std::string quoted = "\"";
+	for (char character : text)
+	{
+		if (character == '"')
+		{
+			quoted += '"';
+		}
+		quoted += character;
+	}
+	return quoted + "\"";
+}
+
+// Hardware event counts as JSON object members, starting with a separating comma
+static std::string json_counters(const CounterValues& counters)
+{
+	return ", \"cycles\": " + std::to_string(counters.cycles) + ", \"instructions\": " + std::to_string(counters.instructions)
+		+ ", \"ipc\": " + std::to_string(counters.ipc()) + ", \"llc_misses\": " + std::to_string(counters.llc_misses)
+		+ ", \"branch_misses\": " + std::to_string(counters.branch_misses);
+}
+
+void BenchmarkReport::write_json(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		throw std::runtime_error("Could not open the benchmark report for writing: " + path);
+	}
+
+	file << std::fixed << std::setprecision(6);
+	file << "{" << std::endl << "  \"results\": [" << std::endl;
+	for (size_t i = 0; i < mResults.size(); ++i)
+	{
+		const BenchmarkResult& result = mResults[i];
+		file << "    {"
+			<< "\"input\": " << json_string(result.input)
+			<< ", \"generator\": " << json_string(result.generator)
+			<< ", \"bits\": " << result.num_of_bits
+			<< ", \"width\": " << result.width
+			<< ", \"height\": " << result.height
+			<< ", \"warmup\": " << result.warmup
+			<< ", \"repetitions\": " << result.repetitions
+			<< ", \"min_ms\": " << result.time.min
+			<< ", \"median_ms\": " << result.time.median
+			<< ", \"p99_ms\": " << result.time.p99
+			<< ", \"mpixels_per_second\": " << result.mpixels_per_second()
+			<< ", \"gigabytes_per_second\": " << result.gigabytes_per_second();
+		if (result.phases.has_counters())
+		{
+			file << json_counters(result.phases.total_counters());
+		}
+
+		file << ", \"phases\": [";
+		const std::vector<TimingPhase>& phases = result.phases.phases();
+		for (size_t j = 0; j < phases.size(); ++j)
+		{
+			file << (j > 0 ? ", " : "") << "{\"name\": " << json_string(phases[j].name)
+				<< ", \"mean_ms\": " << TimingReport::to_milliseconds(phases[j].nanoseconds);
+			if (phases[j].has_counters)
+			{
+				file << json_counters(phases[j].counters);
+			}
+			file << "}";
+		}
+		file << "]}" << (i + 1 < mResults.size() ? "," : "") << std::endl;
+	}
+	file << "  ]" << std::endl << "}" << std::endl;
+
+	if (!file)
+	{
+		throw std::runtime_error("Could not write the benchmark report: " + path);
+	}
+}
+
+void BenchmarkReport::write_csv(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		throw std::runtime_error("Could not open the benchmark report for writing: " + path);
+	}
+
+	file << std::fixed << std::setprecision(6);
+	file << "input,generator,bits,width,height,warmup,repetitions,min_ms,median_ms,p99_ms,mpixels_per_second,gigabytes_per_second,"
+		<< "cycles,instructions,ipc,llc_misses,branch_misses" << std::endl;
+	for (const BenchmarkResult& result : mResults)
+	{
+		file << csv_string(result.input) << "," << csv_string(result.generator) << "," << result.num_of_bits << ","
+			<< result.width << "," << result.height << "," << result.warmup << "," << result.repetitions << ","
+			<< result.time.min << "," << result.time.median << "," << result.time.p99 << ","
+			<< result.mpixels_per_second() << "," << result.gigabytes_per_second() << ",";
+		if (result.phases.has_counters())
+		{
+			// The phases hold the mean counts per run, so their sum is the mean count of a whole run
+			CounterValues counters = result.phases.total_counters();
+			file << counters.cycles << "," << counters.instructions << "," << counters.ipc() << "," << counters.llc_misses << "," << counters.branch_misses;
+		}
+		else
+		{
+			file << ",,,,";
+		}
+		file << std::endl;
+	}
+
+	if (!file)
+	{
+		throw std::runtime_error("Could not write the benchmark report: " + path);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "TimingReport.h"
+
+// Statistics of the times of repeated runs in milliseconds
+struct TimingStatistics
+{
+	float min{0.0f};
+	float median{0.0f};
+	// 99th percentile by the nearest rank, which is the slowest run for fewer than 100 runs
+	float p99{0.0f};
+};
+
+// Compute the statistics of the run times, which don't need to be sorted
+// Will throw a std::runtime_error if there are no times
+TimingStatistics compute_timing_statistics(std::vector<float> times);
+
+// Timing of one generator on one input
+struct BenchmarkResult
+{
+	std::string input;
+	std::string generator;
+	int num_of_bits{0};
+	int width{0};
+	int height{0};
+	int warmup{0};
+	int repetitions{0};
+	TimingStatistics time;
+	// Mean duration and hardware event counts of every phase over the timed runs
+	TimingReport phases;
+
+	// Millions of elements per second at the median time
+	double mpixels_per_second() const;
+	// Gigabytes per second at the median time, counting reading the input and writing the table once each
+	double gigabytes_per_second() const;
+};
+
+/// Collects the benchmark results and writes them as JSON or CSV, so runs on different
+/// builds or machines can be compared to track regressions
+class BenchmarkReport
+{
+public:
+	void add(const BenchmarkResult& result) { mResults.push_back(result); }
+	const std::vector<BenchmarkResult>& results() const { return mResults; }
+
+	// Write the results as an object with a "results" array of one object per result, including
+	// the phases and, if they were counted, the hardware events per run
+	// Will throw a std::runtime_error if the file can't be written
+	void write_json(const std::string& path) const;
+
+	// Write the results as comma separated values with a header row. The hardware event columns are
+	// aggregates: the mean counts of a timed run summed over all its phases, with the IPC of those sums.
+	// The counts of the single phases are only in the JSON report. The columns are empty for results
+	// without performance counters
+	// Will throw a std::runtime_error if the file can't be written
+	void write_csv(const std::string& path) const;
+private:
+	std::vector<BenchmarkResult> mResults;
+};
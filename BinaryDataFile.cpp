@@ -0,0 +1,152 @@
+#include "BinaryDataFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+bool BinaryDataFile::is_binary_file(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	char magic[sizeof(BINARY_FILE_MAGIC)];
+	return file.read(magic, sizeof(magic)) && memcmp(magic, BINARY_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+BinaryFileHeader BinaryDataFile::read_header(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		throw std::runtime_error("Could not open binary file: " + path);
+	}
+	uint64_t file_size = static_cast<uint64_t>(file.tellg());
+	file.seekg(0);
+
+	BinaryFileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, BINARY_FILE_MAGIC, sizeof(header.magic)) != 0)
+	{
+		throw std::runtime_error("The file " + path + " isn't a binary data file");
+	}
+	if (header.version != BINARY_FILE_VERSION)
+	{
+		throw std::runtime_error("The binary file " + path + " has the unsupported version " + std::to_string(header.version));
+	}
+	if (header.num_of_bits != 8 && header.num_of_bits != 16 && header.num_of_bits != 32)
+	{
+		throw std::runtime_error("The binary file " + path + " has the unsupported data type size of " + std::to_string(header.num_of_bits) + " bits");
+	}
+	if (header.payload != BinaryPayload::Input && header.payload != BinaryPayload::SummedAreaTable)
+	{
+		throw std::runtime_error("The binary file " + path + " has an unknown payload kind");
+	}
+
+	// The rows need to be aligned to their elements and lie inside the file
+	uint64_t element_size = header.num_of_bits / 8;
+	uint64_t max_dimension = INT32_MAX;
+	bool valid_size = header.width <= max_dimension && header.height <= max_dimension
+		&& header.row_stride >= header.width * element_size && header.row_stride % element_size == 0
+		&& header.data_offset >= sizeof(BinaryFileHeader) && header.data_offset % element_size == 0 && header.data_offset <= file_size;
+	if (valid_size && header.width > 0 && header.height > 0)
+	{
+		// Divide instead of multiplying the stride, which could overflow
+		uint64_t data_size = file_size - header.data_offset;
+		uint64_t row_bytes = header.width * element_size;
+		valid_size = row_bytes <= data_size && header.height - 1 <= (data_size - row_bytes) / header.row_stride;
+	}
+	if (!valid_size)
+	{
+		throw std::runtime_error("The binary file " + path + " has an invalid size or layout");
+	}
+	return header;
+}
+
+template <typename T>
+BinaryFileHeader BinaryDataFile::create_header(int width, int height, BinaryPayload payload, size_t row_alignment, uint64_t digest)
+{
+	if (row_alignment == 0 || row_alignment % sizeof(T) != 0)
+	{
+		throw std::runtime_error("Invalid row alignment " + std::to_string(row_alignment) + ". It needs to be a multiple of the element size");
+	}
+	auto align = [&](uint64_t size)
+	{
+		return (size + row_alignment - 1) / row_alignment * row_alignment;
+	};
+
+	BinaryFileHeader header;
+	memcpy(header.magic, BINARY_FILE_MAGIC, sizeof(header.magic));
+	header.version = BINARY_FILE_VERSION;
+	header.num_of_bits = DATA_NUM_OF_BITS<T>;
+	header.payload = payload;
+	header.width = static_cast<uint64_t>(width);
+	header.height = static_cast<uint64_t>(height);
+	header.row_stride = align(header.width * sizeof(T));
+	header.data_offset = align(sizeof(BinaryFileHeader));
+	header.digest = digest;
+	return header;
+}
+
+template <typename T>
+void BinaryDataFile::write(const std::string& path, const DataContainer<T>& data, BinaryPayload payload, size_t row_alignment, uint64_t digest)
+{
+	BinaryFileHeader header = create_header<T>(data.width, data.height, payload, row_alignment, digest);
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		throw std::runtime_error("Could not open binary file for writing: " + path);
+	}
+
+	std::vector<char> padding(static_cast<size_t>(std::max<uint64_t>(header.data_offset, header.row_stride)), 0);
+	size_t row_bytes = static_cast<size_t>(data.width) * sizeof(T);
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(padding.data(), static_cast<std::streamsize>(header.data_offset - sizeof(header)));
+	for (int y = 0; y < data.height; ++y)
+	{
+		file.write(reinterpret_cast<const char*>(data.data.data() + static_cast<size_t>(y) * data.width), static_cast<std::streamsize>(row_bytes));
+		file.write(padding.data(), static_cast<std::streamsize>(header.row_stride - row_bytes));
+	}
+
+	if (!file)
+	{
+		throw std::runtime_error("Could not write binary file: " + path);
+	}
+}
+
+template <typename T>
+MappedDataView<T>::MappedDataView(const std::string& path)
+	: mFile(path, MappedFile::Access::Read)
+	, mHeader(BinaryDataFile::read_header(path))
+{
+	if (mHeader.num_of_bits != DATA_NUM_OF_BITS<T>)
+	{
+		throw std::runtime_error("The binary file " + path + " has " + std::to_string(mHeader.num_of_bits) + " bit data, but "
+			+ std::to_string(DATA_NUM_OF_BITS<T>) + " bit data was requested");
+	}
+	mData = reinterpret_cast<const T*>(mFile.map(0, static_cast<size_t>(mFile.size())) + mHeader.data_offset);
+}
+
+template <typename T>
+void MappedDataView<T>::copy_to(DataContainer<T>& data_out) const
+{
+	data_out.width = width();
+	data_out.height = height();
+	data_out.data.resize(static_cast<size_t>(width()) * height());
+	for (int y = 0; y < height(); ++y)
+	{
+		std::copy(row(y), row(y) + width(), data_out.data.begin() + static_cast<size_t>(y) * width());
+	}
+}
+
+template BinaryFileHeader BinaryDataFile::create_header<uint8_t>(int, int, BinaryPayload, size_t, uint64_t);
+template BinaryFileHeader BinaryDataFile::create_header<uint16_t>(int, int, BinaryPayload, size_t, uint64_t);
+template BinaryFileHeader BinaryDataFile::create_header<uint32_t>(int, int, BinaryPayload, size_t, uint64_t);
+
+template void BinaryDataFile::write<uint8_t>(const std::string&, const DataContainer<uint8_t>&, BinaryPayload, size_t, uint64_t);
+template void BinaryDataFile::write<uint16_t>(const std::string&, const DataContainer<uint16_t>&, BinaryPayload, size_t, uint64_t);
+template void BinaryDataFile::write<uint32_t>(const std::string&, const DataContainer<uint32_t>&, BinaryPayload, size_t, uint64_t);
+
+template class MappedDataView<uint8_t>;
+template class MappedDataView<uint16_t>;
+template class MappedDataView<uint32_t>;
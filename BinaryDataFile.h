@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "DataContainer.h"
+#include "MappedFile.h"
+
+// Kind of data stored in a binary data file
+enum class BinaryPayload : uint32_t
+{
+	// Input values for a generator
+	Input = 0,
+	// A finished summed area table
+	SummedAreaTable = 1
+};
+
+// Header at the start of a binary data file. All fields are in the native byte order
+struct BinaryFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	// Number of bits in the unsigned integer elements: 8, 16 or 32
+	uint32_t num_of_bits;
+	BinaryPayload payload;
+	uint64_t width;
+	uint64_t height;
+	// Bytes from the start of one row to the start of the next, at least a row of elements
+	uint64_t row_stride;
+	// Byte offset of the first row from the start of the file
+	uint64_t data_offset;
+	// Digest of the data the file was made from, 0 if none was given. The table cache checks hits against it
+	uint64_t digest;
+};
+static_assert(sizeof(BinaryFileHeader) == 56, "The binary file header has a fixed size of 56 bytes");
+
+static const char BINARY_FILE_MAGIC[4] = { 'S', 'A', 'T', 'B' };
+static const uint32_t BINARY_FILE_VERSION = 2;
+
+/// Binary data file format for inputs and summed area tables
+/// A file is the header followed by the rows of raw elements. The first row and every row stride
+/// are aligned, so the data can be memory mapped and used in place without parsing or copying.
+class BinaryDataFile
+{
+public:
+	// Check if the file starts with the binary data file magic
+	static bool is_binary_file(const std::string& path);
+
+	// Read and validate the header of a binary data file
+	// Will throw a std::runtime_error if the file can't be read or the header is invalid or doesn't match the file size
+	static BinaryFileHeader read_header(const std::string& path);
+
+	// Create the header of a file of width * height elements of type T with aligned rows like write uses.
+	// The file has data_offset + height * row_stride bytes
+	// Will throw a std::runtime_error if the alignment is invalid
+	template <typename T>
+	static BinaryFileHeader create_header(int width, int height, BinaryPayload payload, size_t row_alignment = DEFAULT_ROW_ALIGNMENT,
+		uint64_t digest = 0);
+
+	// Write the data to a binary data file. The first row and the row stride are aligned to row_alignment bytes,
+	// which needs to be a multiple of the element size. The digest is stored in the header
+	// Will throw a std::runtime_error if the file can't be written or the alignment is invalid
+	template <typename T>
+	static void write(const std::string& path, const DataContainer<T>& data, BinaryPayload payload, size_t row_alignment = DEFAULT_ROW_ALIGNMENT,
+		uint64_t digest = 0);
+
+	static const size_t DEFAULT_ROW_ALIGNMENT = 64;
+};
+
+/// Read-only view of a memory mapped binary data file with elements of type T
+/// The rows are used in place in the mapping, so opening even a large table copies nothing.
+/// Rows may be padded, so row y starts at data() + y * row_stride().
+template <typename T>
+class MappedDataView
+{
+public:
+	// Map the binary data file
+	// Will throw a std::runtime_error if the file isn't a valid binary data file or its elements aren't of type T
+	explicit MappedDataView(const std::string& path);
+
+	int width() const { return static_cast<int>(mHeader.width); }
+	int height() const { return static_cast<int>(mHeader.height); }
+	// Elements from the start of one row to the start of the next
+	size_t row_stride() const { return static_cast<size_t>(mHeader.row_stride / sizeof(T)); }
+	BinaryPayload payload() const { return mHeader.payload; }
+	uint64_t digest() const { return mHeader.digest; }
+
+	const T* data() const { return mData; }
+	const T* row(int y) const { return mData + static_cast<size_t>(y) * row_stride(); }
+	T value(int x, int y) const { return row(y)[x]; }
+
+	// Copy the rows into data_out without the padding
+	void copy_to(DataContainer<T>& data_out) const;
+private:
+	MappedFile mFile;
+	BinaryFileHeader mHeader;
+	const T* mData{nullptr};
+};
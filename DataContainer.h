@@ -1,14 +1,62 @@
 #pragma once
 
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "constants.h"
 
+// How the values of a container with several channels are ordered
+enum class ChannelLayout
+{
+	// The channels of a pixel next to each other, like RGBRGB
+	Interleaved,
+	// One whole width x height image per channel, one after the other
+	Planar
+};
+
 // Simple container for input and output data for the summed area table
+// T is the element type: uint8_t, uint16_t or uint32_t
+template <typename T>
 struct DataContainer
 {
 	int width{0};
 	int height{0};
 	// A flat vector is for ease of use in this demo. In real use case we would probably only be operating on textures
-	std::vector<data_t> data;
-};
\ No newline at end of file
+	std::vector<T> data;
+	// Values per pixel, like 3 for RGB, so data holds width * height * channels values.
+	// Only SummedAreaTableGeneratorCpuMultiChannelImpl handles more than one channel
+	int channels{1};
+	ChannelLayout channel_layout{ChannelLayout::Interleaved};
+};
+
+// Container for volumes, like the frames of a video clip or the slices of a CT scan
+// The depth slices are stored one after the other, each one row-major like a DataContainer
+template <typename T>
+struct VolumeContainer
+{
+	int width{0};
+	int height{0};
+	int depth{0};
+	std::vector<T> data;
+};
+
+// Call function with a value of the unsigned integer type that has the given number of bits,
+// so a generic lambda can instantiate the templated code for the type selected at runtime:
+// dispatch_data_type(bits, [&](auto type_tag) { typedef decltype(type_tag) T; ... });
+// Will throw a std::runtime_error if the number of bits isn't supported
+template <typename Function>
+auto dispatch_data_type(int num_of_bits, Function&& function)
+{
+	switch (num_of_bits)
+	{
+		case 8:
+			return function(uint8_t{});
+		case 16:
+			return function(uint16_t{});
+		case 32:
+			return function(uint32_t{});
+		default:
+			throw std::runtime_error("Unsupported data type size of " + std::to_string(num_of_bits) + " bits!");
+	}
+}
@@ -0,0 +1,109 @@
+#include "FenwickTree2D.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+template <typename T>
+FenwickTree2D<T>::FenwickTree2D(const DataContainer<T>& data)
+{
+	build(data);
+}
+
+template <typename T>
+void FenwickTree2D<T>::build(const DataContainer<T>& data)
+{
+	mWidth = data.width;
+	mHeight = data.height;
+	mTree.assign(data.data.begin(), data.data.end());
+
+	// Every node adds its range to the next node covering it. Doing this along the rows and then
+	// along the columns builds the 2D tree, because the node ranges are separable
+	for (int y = 0; y < mHeight; ++y)
+	{
+		uint64_t* row = mTree.data() + static_cast<size_t>(y) * mWidth;
+		for (int x = 0; x < mWidth; ++x)
+		{
+			int parent = x | (x + 1);
+			if (parent < mWidth)
+			{
+				row[parent] += row[x];
+			}
+		}
+	}
+
+	for (int y = 0; y < mHeight; ++y)
+	{
+		int parent = y | (y + 1);
+		if (parent >= mHeight)
+		{
+			continue;
+		}
+
+		const uint64_t* row = mTree.data() + static_cast<size_t>(y) * mWidth;
+		uint64_t* parent_row = mTree.data() + static_cast<size_t>(parent) * mWidth;
+		for (int x = 0; x < mWidth; ++x)
+		{
+			parent_row[x] += row[x];
+		}
+	}
+}
+
+template <typename T>
+void FenwickTree2D<T>::add(int x, int y, int64_t delta)
+{
+	if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+	{
+		throw std::runtime_error("Fenwick tree update at (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside the data!");
+	}
+
+	for (int node_y = y; node_y < mHeight; node_y |= node_y + 1)
+	{
+		uint64_t* row = mTree.data() + static_cast<size_t>(node_y) * mWidth;
+		for (int node_x = x; node_x < mWidth; node_x |= node_x + 1)
+		{
+			row[node_x] += static_cast<uint64_t>(delta);
+		}
+	}
+}
+
+template <typename T>
+uint64_t FenwickTree2D<T>::prefix_sum(int x, int y) const
+{
+	x = std::min(x, mWidth - 1);
+	y = std::min(y, mHeight - 1);
+
+	uint64_t sum = 0;
+	for (int node_y = y; node_y >= 0; node_y = (node_y & (node_y + 1)) - 1)
+	{
+		const uint64_t* row = mTree.data() + static_cast<size_t>(node_y) * mWidth;
+		for (int node_x = x; node_x >= 0; node_x = (node_x & (node_x + 1)) - 1)
+		{
+			sum += row[node_x];
+		}
+	}
+	return sum;
+}
+
+template <typename T>
+uint64_t FenwickTree2D<T>::box_sum(const QueryRectangle& rectangle) const
+{
+	int64_t x_begin = std::max(rectangle.x, 0);
+	int64_t y_begin = std::max(rectangle.y, 0);
+	int64_t x_end = std::min<int64_t>(static_cast<int64_t>(rectangle.x) + rectangle.width, mWidth);
+	int64_t y_end = std::min<int64_t>(static_cast<int64_t>(rectangle.y) + rectangle.height, mHeight);
+	if (x_begin >= x_end || y_begin >= y_end)
+	{
+		return 0;
+	}
+
+	int x_last = static_cast<int>(x_end - 1);
+	int y_last = static_cast<int>(y_end - 1);
+	int x_before = static_cast<int>(x_begin - 1);
+	int y_before = static_cast<int>(y_begin - 1);
+	return prefix_sum(x_last, y_last) - prefix_sum(x_before, y_last) - prefix_sum(x_last, y_before) + prefix_sum(x_before, y_before);
+}
+
+template class FenwickTree2D<uint8_t>;
+template class FenwickTree2D<uint16_t>;
+template class FenwickTree2D<uint32_t>;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "DataContainer.h"
+#include "SummedAreaTableQuery.h"
+
+/// 2D Fenwick tree (binary indexed tree) over input data, for workloads that interleave point
+/// updates and region queries. A summed area table answers a query in O(1) but needs O(W * H)
+/// work to reflect an update, while the tree does both in O(log W * log H).
+/// Sums are kept in 64 bits without saturation or wraparound at the input type maximum.
+template <typename T>
+class FenwickTree2D
+{
+public:
+	FenwickTree2D() = default;
+
+	// Build the tree of the data, see build()
+	explicit FenwickTree2D(const DataContainer<T>& data);
+
+	// Build the tree of the data in O(W * H) by pushing every node to its parent, first along
+	// the rows and then along the columns
+	void build(const DataContainer<T>& data);
+
+	// Add delta to the input value at (x, y). Sums are modulo 2^64, so negative deltas work.
+	// Will throw std::runtime_error if the position is outside the data
+	void add(int x, int y, int64_t delta);
+
+	// Sum of the input values in the rectangle from (0, 0) to (x, y) inclusive, the same element
+	// a summed area table stores at (x, y). Positions outside the data are clamped
+	uint64_t prefix_sum(int x, int y) const;
+
+	// Sum of the input values inside the rectangle clamped to the data borders
+	uint64_t box_sum(const QueryRectangle& rectangle) const;
+
+	int width() const { return mWidth; }
+	int height() const { return mHeight; }
+private:
+	int mWidth{0};
+	int mHeight{0};
+	// Node (x, y) holds the sum of the input over the ranges (x & (x + 1)) .. x and (y & (y + 1)) .. y
+	std::vector<uint64_t> mTree;
+};
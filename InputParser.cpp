@@ -1,147 +1,614 @@
 #include "InputParser.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
-#include <ctype.h>
 #include <stdexcept>
 #include <filesystem>
+#include <limits>
+#include <sstream>
 
 #include "constants.h"
+#include "BinaryDataFile.h"
+#include "InputParserSimdTokenizer.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+#include "SystemMemory.h"
 
-void InputParser::parse_command_line_arguments(int argument_count, char* arguments[], 
-	std::string& input_file_out, std::string& shader_directory_out, bool& print_help_out)
+void InputParser::parse_command_line_arguments(int argument_count, char* arguments[], CommandLineOptions& options_out)
 {
-	input_file_out = DEFAULT_INPUT_FILE;
-	shader_directory_out = DEFAULT_SHADER_DIRECTORY;
-	print_help_out = false;
+	options_out = CommandLineOptions{};
+	options_out.input_file = DEFAULT_INPUT_FILE;
+	options_out.shader_directory = DEFAULT_SHADER_DIRECTORY;
 
 	std::string argument;
-	bool next_argument_is_input_file = false;
-	bool next_argument_is_shader_directory = false;
 
 	for (int i = 0; i < argument_count; ++i)
 	{
 		argument = arguments[i];
+		bool has_value = i + 1 < argument_count;
 
-		if (next_argument_is_input_file)
+		if (is_option(argument, "s", "shader_dir") && has_value)
 		{
-			input_file_out = argument;
-			next_argument_is_input_file = false;
+			options_out.shader_directory = arguments[++i];
 		}
-		if (next_argument_is_shader_directory)
+		else if (is_option(argument, "f", "file") && has_value)
 		{
-			shader_directory_out = argument;
-			next_argument_is_shader_directory = false;
+			options_out.input_file = arguments[++i];
 		}
-
-		if (argument == "--s" || argument == "-s" || argument == "-shader_dir" || argument == "--shader_dir")
+		else if (is_option(argument, "g", "generator") && has_value)
+		{
+			options_out.cpu_generator = arguments[++i];
+			const std::vector<std::string>& names = SummedAreaTableGeneratorFactory::cpu_generator_names();
+			if (options_out.cpu_generator != "all" && std::find(names.begin(), names.end(), options_out.cpu_generator) == names.end())
+			{
+				throw std::runtime_error("Unknown CPU generator " + options_out.cpu_generator);
+			}
+		}
+		else if (is_option(argument, "b", "bits") && has_value)
+		{
+			std::string value = arguments[++i];
+			options_out.data_num_of_bits = parse_integer_option(value, "number of bits", 8);
+			if (options_out.data_num_of_bits != 8 && options_out.data_num_of_bits != 16 && options_out.data_num_of_bits != 32)
+			{
+				throw std::runtime_error("Invalid number of bits " + value + ". Supported values are 8, 16 and 32");
+			}
+		}
+		else if (is_option(argument, "t", "threads") && has_value)
+		{
+			options_out.generator_settings.thread_count = parse_integer_option(arguments[++i], "thread count", 0);
+		}
+		else if (is_option(argument, "ts", "tile_size") && has_value)
+		{
+			options_out.generator_settings.tile_size = parse_integer_option(arguments[++i], "tile size", 1);
+		}
+		else if (is_option(argument, "st", "stream"))
+		{
+			options_out.stream = true;
+		}
+		else if (is_option(argument, "o", "output") && has_value)
+		{
+			options_out.output_file = arguments[++i];
+		}
+		else if (is_option(argument, "bo", "binary_output") && has_value)
+		{
+			options_out.binary_output_file = arguments[++i];
+		}
+		else if (is_option(argument, "c", "cache") && has_value)
+		{
+			options_out.cache_directory = arguments[++i];
+		}
+		else if (is_option(argument, "cs", "cache_size") && has_value)
+		{
+			options_out.cache_size_mb = parse_integer_option(arguments[++i], "cache size", 1);
+		}
+		else if (is_option(argument, "sy", "synthetic") && has_value)
+		{
+			options_out.synthetic = true;
+			options_out.synthetic_settings.pattern = SyntheticInput::parse_pattern(arguments[++i]);
+		}
+		else if (is_option(argument, "sz", "size") && has_value)
 		{
-			next_argument_is_shader_directory = true;
+			parse_size_option(arguments[++i], options_out.synthetic_settings.width, options_out.synthetic_settings.height);
 		}
-		else if (argument == "--f" || argument == "-f" || argument == "-file" || argument == "--file")
+		else if (is_option(argument, "sd", "seed") && has_value)
 		{
-			next_argument_is_input_file = true;
+			options_out.synthetic_settings.seed = static_cast<uint64_t>(parse_integer_option(arguments[++i], "seed", 0));
 		}
-		else if (argument == "--h" || argument == "-h" || argument == "-help" || argument == "--help")
+		else if (is_option(argument, "so", "synthetic_output") && has_value)
 		{
-			print_help_out = true;
+			options_out.synthetic_output_file = arguments[++i];
+		}
+		else if (is_option(argument, "pc", "perf_counters"))
+		{
+			options_out.performance_counters = true;
+		}
+		else if (is_option(argument, "w", "wrap"))
+		{
+			options_out.generator_settings.overflow_mode = OverflowMode::Wrap;
+		}
+		else if (is_option(argument, "h", "help"))
+		{
+			options_out.print_help = true;
 		}
 	}
 }
 
-void InputParser::parse_input_file(const std::string& input_file, DataContainer& data_out)
+bool InputParser::is_option(const std::string& argument, const std::string& short_name, const std::string& long_name)
+{
+	return argument == "-" + short_name || argument == "--" + short_name
+		|| argument == "-" + long_name || argument == "--" + long_name;
+}
+
+int InputParser::parse_integer_option(const std::string& value, const std::string& option_name, int min_value)
+{
+	int number;
+	try
+	{
+		number = std::stoi(value);
+	}
+	catch (const std::exception&)
+	{
+		throw std::runtime_error("Invalid " + option_name + " " + value);
+	}
+
+	if (number < min_value)
+	{
+		throw std::runtime_error("Invalid " + option_name + " " + value + ". The minimum is " + std::to_string(min_value));
+	}
+	return number;
+}
+
+void InputParser::parse_size_option(const std::string& value, int& width_out, int& height_out)
+{
+	size_t separator = value.find_first_of("xX");
+	if (separator == std::string::npos)
+	{
+		width_out = parse_integer_option(value, "size", 1);
+		height_out = width_out;
+		return;
+	}
+	width_out = parse_integer_option(value.substr(0, separator), "width", 1);
+	height_out = parse_integer_option(value.substr(separator + 1), "height", 1);
+}
+
+template <typename T>
+void InputParser::parse_input_file(const std::string& input_file, DataContainer<T>& data_out, int thread_count)
 {
 	if (!std::filesystem::exists(input_file))
 	{
 		throw std::runtime_error("Could not find input file: " + input_file);
 	}
 
-	data_out.data.reserve(INPUT_DATA_MAX_WIDTH * INPUT_DATA_MAX_HEIGHT);
+	MappedFile file(input_file, MappedFile::Access::Read);
+	const char* position = file.size() > 0 ? reinterpret_cast<const char*>(file.map(0, static_cast<size_t>(file.size()))) : nullptr;
+	const char* file_end = position + file.size();
 
-	std::ifstream file(input_file);
-	std::string line;
-	std::string token = "";
+	if (file.size() >= sizeof(BINARY_FILE_MAGIC) && memcmp(position, BINARY_FILE_MAGIC, sizeof(BINARY_FILE_MAGIC)) == 0)
+	{
+		parse_binary_file(input_file, data_out);
+		return;
+	}
+
+	int chunk_count = static_cast<int>(std::min<uint64_t>(resolve_thread_count(thread_count), file.size() / PARALLEL_MIN_CHUNK_SIZE));
+	if (chunk_count > 1)
+	{
+		parse_input_chunks(position, file_end, chunk_count, data_out);
+		return;
+	}
+
+	data_out.data.clear();
 
 	int current_line = 0;
 	int current_line_width = 0;
 	int first_line_width = 0;
+	int max_height = 0;
 
-	while (getline(file, line))
+	// Lines are split like getline does: a newline at the end of the file doesn't start another line
+	while (position < file_end)
 	{
+		const char* line_end = static_cast<const char*>(memchr(position, '\n', file_end - position));
+		if (line_end == nullptr)
+		{
+			line_end = file_end;
+		}
+
 		++current_line;
-		current_line_width = 0;
+		current_line_width = parse_line(position, line_end, current_line, max_input_width<T>(), data_out.data, std::cout);
 
-		for (char symbol : line)
+		if (current_line == 1)
 		{
-			if (isdigit(symbol))
+			first_line_width = current_line_width;
+			max_height = max_input_height<T>(first_line_width);
+
+			// Reserve for the whole file having lines as long as the first one
+			uint64_t estimated_lines = static_cast<uint64_t>(file_end - position) / static_cast<uint64_t>(line_end - position + 1) + 1;
+			data_out.data.reserve(static_cast<size_t>(std::min(estimated_lines * first_line_width, max_input_values<T>())));
+		}
+		check_line(current_line, current_line_width, first_line_width, max_height);
+
+		position = line_end < file_end ? line_end + 1 : file_end;
+	}
+
+	data_out.width = current_line_width;
+	data_out.height = current_line;
+}
+
+template <typename T>
+void InputParser::parse_binary_file(const std::string& input_file, DataContainer<T>& data_out)
+{
+	MappedDataView<T> view(input_file);
+	if (view.payload() != BinaryPayload::Input)
+	{
+		throw std::runtime_error("The binary file " + input_file + " contains a summed area table instead of input data");
+	}
+	if (static_cast<uint64_t>(view.width()) * view.height() > max_input_values<T>())
+	{
+		throw std::runtime_error("The given input file has too much data for the memory of this computer! The maximum is "
+			+ std::to_string(max_input_values<T>()) + " values");
+	}
+	view.copy_to(data_out);
+}
+
+template <typename T>
+void InputParser::parse_input_chunks(const char* file_begin, const char* file_end, int chunk_count, DataContainer<T>& data_out)
+{
+	// The chunks start at the first line start at or after equal shares of the file
+	std::vector<const char*> chunk_begins(chunk_count + 1, file_end);
+	chunk_begins[0] = file_begin;
+	for (int chunk = 1; chunk < chunk_count; ++chunk)
+	{
+		const char* share_begin = file_begin + (file_end - file_begin) * chunk / chunk_count;
+		chunk_begins[chunk] = chunk_begins[chunk - 1];
+		if (share_begin > chunk_begins[chunk])
+		{
+			const char* newline = static_cast<const char*>(memchr(share_begin - 1, '\n', file_end - share_begin + 1));
+			chunk_begins[chunk] = newline != nullptr ? newline + 1 : file_end;
+		}
+	}
+
+	// Count the lines of every chunk to know the line number each one starts at. Like getline, a
+	// newline at the end of the file doesn't start another line
+	std::vector<int64_t> chunk_first_lines(chunk_count + 1, 0);
+	parallel_for(chunk_count, chunk_count, [&](int begin, int end)
+	{
+		for (int chunk = begin; chunk < end; ++chunk)
+		{
+			const char* chunk_begin = chunk_begins[chunk];
+			const char* chunk_end = chunk_begins[chunk + 1];
+			int64_t newlines = std::count(chunk_begin, chunk_end, '\n');
+			chunk_first_lines[chunk + 1] = newlines + (chunk_end > chunk_begin && chunk_end[-1] != '\n' ? 1 : 0);
+		}
+	});
+	for (int chunk = 0; chunk < chunk_count; ++chunk)
+	{
+		chunk_first_lines[chunk + 1] += chunk_first_lines[chunk];
+	}
+	int64_t line_count = chunk_first_lines[chunk_count];
+
+	// The first line gives the width of the rows
+	const char* first_line_end = static_cast<const char*>(memchr(file_begin, '\n', file_end - file_begin));
+	if (first_line_end == nullptr)
+	{
+		first_line_end = file_end;
+	}
+	data_out.data.clear();
+	int width = parse_line(file_begin, first_line_end, 1, max_input_width<T>(), data_out.data, std::cout);
+
+	// Lines after the maximum height only need parsing up to the first one, which is an error
+	int max_height = max_input_height<T>(width);
+	int height = static_cast<int>(std::min<int64_t>(line_count, static_cast<int64_t>(max_height) + 1));
+	data_out.data.resize(static_cast<size_t>(width) * height);
+
+	// Every chunk parses its lines into their rows and stops at its first error. The messages are
+	// collected per chunk so they can be printed in the order of the lines
+	struct ChunkResult
+	{
+		std::ostringstream messages;
+		bool failed{false};
+		std::string error;
+	};
+	std::vector<ChunkResult> results(chunk_count);
+
+	parallel_for(chunk_count, chunk_count, [&](int begin, int end)
+	{
+		for (int chunk = begin; chunk < end; ++chunk)
+		{
+			ChunkResult& result = results[chunk];
+			const char* position = chunk_begins[chunk];
+			const char* chunk_end = chunk_begins[chunk + 1];
+			int64_t current_line = chunk_first_lines[chunk];
+
+			try
 			{
-				token += symbol;
+				while (position < chunk_end && current_line < height)
+				{
+					const char* line_end = static_cast<const char*>(memchr(position, '\n', chunk_end - position));
+					if (line_end == nullptr)
+					{
+						line_end = chunk_end;
+					}
+
+					++current_line;
+					if (current_line > 1)
+					{
+						int line = static_cast<int>(current_line);
+						T* row = data_out.data.data() + static_cast<size_t>(line - 1) * width;
+						int line_width = parse_line_values<T>(position, line_end, line, max_input_width<T>(), [&](int index, T value)
+						{
+							// Lines with more values than the first one are an error after the parse
+							if (index < width)
+							{
+								row[index] = value;
+							}
+						}, result.messages);
+						check_line(line, line_width, width, max_height);
+					}
+
+					position = line_end < chunk_end ? line_end + 1 : chunk_end;
+				}
 			}
-			else // Parse the token when encountering a non-number symbol
+			catch (const std::exception& exception)
 			{
-				parse_token(token, data_out, current_line_width, current_line);
+				result.failed = true;
+				result.error = exception.what();
 			}
 		}
+	});
 
-		// Parse the last token of the line if there was no whitespace or other non-number
-		// symbols at the end of the line
-		parse_token(token, data_out, current_line_width, current_line);
+	// The chunks are in the order of the lines, so the first failed chunk has the first error
+	for (ChunkResult& result : results)
+	{
+		std::cout << result.messages.str();
+		if (result.failed)
+		{
+			throw std::runtime_error(result.error);
+		}
+	}
 
-		if (current_line == 1)
+	data_out.width = width;
+	data_out.height = height;
+}
+
+const char* InputParser::tokenizer_name()
+{
+#ifdef SAT_SIMD_TOKENIZER_AVAILABLE
+	return tokenizer_path_name(tokenizer_path());
+#else
+	return "scalar";
+#endif
+}
+
+void InputParser::check_line(int current_line, int line_width, int first_line_width, int max_height)
+{
+	if (line_width > first_line_width)
+	{
+		throw std::runtime_error("Line " + std::to_string(current_line) + " has more data than the others!");
+	}
+	if (line_width < first_line_width)
+	{
+		throw std::runtime_error("Line " + std::to_string(current_line) + " has less data than the others!");
+	}
+	if (current_line > max_height)
+	{
+		throw std::runtime_error("The given input file has too many lines! The maximum is " + std::to_string(max_height)
+			+ " lines of this width for the memory of this computer");
+	}
+}
+
+template <typename T>
+uint64_t InputParser::max_input_values()
+{
+	return physical_memory_size() / INPUT_DATA_MEMORY_FRACTION / sizeof(T);
+}
+
+template <typename T>
+int InputParser::max_input_width()
+{
+	return static_cast<int>(std::min<uint64_t>(max_input_values<T>(), std::numeric_limits<int>::max()));
+}
+
+template <typename T>
+int InputParser::max_input_height(int width)
+{
+	// One less than the largest int, so counting the line after the last one can't overflow
+	uint64_t lines = max_input_values<T>() / static_cast<uint64_t>(std::max(width, 1));
+	return static_cast<int>(std::min<uint64_t>(lines, std::numeric_limits<int>::max() - 1));
+}
+
+template <typename T>
+int InputParser::parse_line(const char* line_begin, const char* line_end, int current_line, int max_width, std::vector<T>& values_out, std::ostream& message_stream)
+{
+	return parse_line_values<T>(line_begin, line_end, current_line, max_width, [&](int, T value)
+	{
+		values_out.push_back(value);
+	}, message_stream);
+}
+
+#ifdef SAT_SIMD_TOKENIZER_AVAILABLE
+// Tokenize the whole blocks at the start of the line from their digit masks, and return where the rest of
+// the line starts. Numbers the SIMD conversion can't handle go through parse_long_number. A block always
+// starts outside of a number, because a number reaching the end of a block is finished before moving on.
+// Forced inline, so the tokenizer functions are inlined into the callers compiled for their instruction set
+template <typename T, typename Tokenizer, typename Output, typename ParseLongNumber>
+static SAT_TOKENIZER_FORCE_INLINE const char* tokenize_blocks(const char* position, const char* line_end, int current_line, int max_width,
+	int& current_line_width, Output& output, ParseLongNumber& parse_long_number)
+{
+	while (line_end - position >= Tokenizer::BLOCK_SIZE)
+	{
+		uint64_t digits = Tokenizer::digit_mask(position);
+		uint64_t number_starts = digits & ~(digits << 1);
+		const char* block_end = position + Tokenizer::BLOCK_SIZE;
+		const char* next_block = block_end;
+
+		while (number_starts != 0)
 		{
-			first_line_width = current_line_width;
+			int start = tokenizer_count_trailing_zeros(number_starts);
+			number_starts &= number_starts - 1;
+
+			// The digits run up to the first clear bit, at the latest the end of the block
+			const char* token_begin = position + start;
+			const char* token_end = token_begin + tokenizer_count_trailing_zeros(~(digits >> start));
+			if (token_end == block_end)
+			{
+				while (token_end < line_end && static_cast<unsigned char>(*token_end - '0') <= 9)
+				{
+					++token_end;
+				}
+				next_block = token_end;
+			}
+
+			// Single digits are cheapest to convert directly and other short numbers with SIMD, if the
+			// load stays inside the line. Long and clipped ones go through parse_number, which also
+			// reports the clipping
+			int digit_count = static_cast<int>(token_end - token_begin);
+			uint64_t number = DATA_MAX_VALUE<T> + 1;
+			if (digit_count == 1)
+			{
+				number = static_cast<uint64_t>(*token_begin - '0');
+			}
+			else if (digit_count <= TOKENIZER_MAX_SIMD_DIGITS && line_end - token_begin >= TOKENIZER_DIGITS_LOAD_SIZE)
+			{
+				number = tokenizer_parse_digits(token_begin, digit_count);
+			}
+			if (number <= DATA_MAX_VALUE<T>)
+			{
+				output(current_line_width, static_cast<T>(number));
+			}
+			else
+			{
+				output(current_line_width, parse_long_number(token_begin, token_end));
+			}
+			++current_line_width;
+
+			if (current_line_width > max_width)
+			{
+				throw std::runtime_error("Line " + std::to_string(current_line) + " contains too much data! The maximum is " + std::to_string(max_width));
+			}
 		}
+		position = next_block;
+	}
+	return position;
+}
+
+template <typename T, typename Output, typename ParseLongNumber>
+SAT_TOKENIZER_TARGET_AVX2 static const char* tokenize_blocks_avx2(const char* position, const char* line_end, int current_line, int max_width,
+	int& current_line_width, Output& output, ParseLongNumber& parse_long_number)
+{
+	return tokenize_blocks<T, TokenizerAvx2>(position, line_end, current_line, max_width, current_line_width, output, parse_long_number);
+}
 
-		if (current_line_width > first_line_width)
+template <typename T, typename Output, typename ParseLongNumber>
+SAT_TOKENIZER_TARGET_SSE41 static const char* tokenize_blocks_sse41(const char* position, const char* line_end, int current_line, int max_width,
+	int& current_line_width, Output& output, ParseLongNumber& parse_long_number)
+{
+	return tokenize_blocks<T, TokenizerSse41>(position, line_end, current_line, max_width, current_line_width, output, parse_long_number);
+}
+#endif
+
+template <typename T, typename Output>
+int InputParser::parse_line_values(const char* line_begin, const char* line_end, int current_line, int max_width, Output output, std::ostream& message_stream)
+{
+	int current_line_width = 0;
+	const char* position = line_begin;
+
+#ifdef SAT_SIMD_TOKENIZER_AVAILABLE
+	auto parse_long_number = [&](const char* token_begin, const char* token_end)
+	{
+		return parse_number<T>(token_begin, token_end, current_line, message_stream);
+	};
+
+	switch (tokenizer_path())
+	{
+	case TokenizerPath::Avx2:
+		position = tokenize_blocks_avx2<T>(position, line_end, current_line, max_width, current_line_width, output, parse_long_number);
+		break;
+	case TokenizerPath::Sse41:
+		position = tokenize_blocks_sse41<T>(position, line_end, current_line, max_width, current_line_width, output, parse_long_number);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	while (position < line_end)
+	{
+		// Skip the non-number symbols between the numbers
+		if (static_cast<unsigned char>(*position - '0') > 9)
 		{
-			throw std::runtime_error("Line " + std::to_string(current_line) + " has more data than the others!");
+			++position;
+			continue;
 		}
-		if (current_line_width < first_line_width)
+
+		const char* token_begin = position;
+		while (position < line_end && static_cast<unsigned char>(*position - '0') <= 9)
 		{
-			throw std::runtime_error("Line " + std::to_string(current_line) + " has less data than the others!");
+			++position;
 		}
-		if (current_line > INPUT_DATA_MAX_HEIGHT)
+
+		output(current_line_width, parse_number<T>(token_begin, position, current_line, message_stream));
+		++current_line_width;
+
+		if (current_line_width > max_width)
 		{
-			throw std::runtime_error("The given input file has too many lines! The maximum is " + std::to_string(INPUT_DATA_MAX_HEIGHT));
+			throw std::runtime_error("Line " + std::to_string(current_line) + " contains too much data! The maximum is " + std::to_string(max_width));
 		}
 	}
-
-	data_out.width = current_line_width;
-	data_out.height = current_line;
+	return current_line_width;
 }
 
-void InputParser::parse_token(std::string& token, DataContainer& data, int& current_line_width, int current_line)
+template <typename T>
+T InputParser::parse_number(const char* token_begin, const char* token_end, int current_line, std::ostream& message_stream)
 {
-	if (token.empty()) // Ignore consecutive non-number symbols
+	// Stop accumulating once the number is too large. It can't overflow, since the maximum of T
+	// times ten still fits in 64 bits
+	uint64_t number = 0;
+	for (const char* digit = token_begin; digit < token_end && number <= DATA_MAX_VALUE<T>; ++digit)
 	{
-		return;
+		number = number * 10 + static_cast<uint64_t>(*digit - '0');
 	}
 
-	int number;
-
-	try
+	if (number > DATA_MAX_VALUE<T>)
 	{
-		number = std::stoi(token);
+		message_stream << "Noncritical error: Number " << std::string(token_begin, token_end) << " clipped to " << DATA_MAX_VALUE<T>
+			<< " at line " << current_line << std::endl;
+		number = DATA_MAX_VALUE<T>;
 	}
-	catch (std::invalid_argument ex)
+	return static_cast<T>(number);
+}
+
+template <typename T>
+InputRowReader<T>::InputRowReader(const std::string& input_file, std::ostream& message_stream)
+	: mFile(input_file)
+	, mMessageStream(message_stream)
+{
+	if (!mFile)
 	{
-		throw std::runtime_error("Unknown input " + token + " at line " + std::to_string(current_line));
+		throw std::runtime_error("Could not open input file: " + input_file);
 	}
+}
 
-	if (number > DATA_MAX_VALUE)
+template <typename T>
+bool InputRowReader<T>::read_row(std::vector<T>& row_out)
+{
+	if (!getline(mFile, mLine))
 	{
-		std::cout << "Noncritical error: Number " << token << " clipped to " << DATA_MAX_VALUE
-			<< " at line " << current_line << std::endl;
-		number = DATA_MAX_VALUE;
+		return false;
 	}
 
-	data.data.emplace_back(number);
+	++mCurrentLine;
+	row_out.clear();
+	int current_line_width = InputParser::parse_line(mLine, mCurrentLine, std::numeric_limits<int>::max(), row_out, mMessageStream);
 
-	token = "";
-	++current_line_width;
+	if (mCurrentLine == 1)
+	{
+		mWidth = current_line_width;
+	}
 
-	if (current_line_width > INPUT_DATA_MAX_WIDTH)
+	if (current_line_width > mWidth)
 	{
-		throw std::runtime_error("Line " + std::to_string(current_line) + " contains too much data! The maximum is " + std::to_string(INPUT_DATA_MAX_WIDTH));
+		throw std::runtime_error("Line " + std::to_string(mCurrentLine) + " has more data than the others!");
 	}
+	if (current_line_width < mWidth)
+	{
+		throw std::runtime_error("Line " + std::to_string(mCurrentLine) + " has less data than the others!");
+	}
+	return true;
 }
+
+template void InputParser::parse_input_file<uint8_t>(const std::string&, DataContainer<uint8_t>&, int);
+template void InputParser::parse_input_file<uint16_t>(const std::string&, DataContainer<uint16_t>&, int);
+template void InputParser::parse_input_file<uint32_t>(const std::string&, DataContainer<uint32_t>&, int);
+
+template uint64_t InputParser::max_input_values<uint8_t>();
+template uint64_t InputParser::max_input_values<uint16_t>();
+template uint64_t InputParser::max_input_values<uint32_t>();
+
+template int InputParser::parse_line<uint8_t>(const char*, const char*, int, int, std::vector<uint8_t>&, std::ostream&);
+template int InputParser::parse_line<uint16_t>(const char*, const char*, int, int, std::vector<uint16_t>&, std::ostream&);
+template int InputParser::parse_line<uint32_t>(const char*, const char*, int, int, std::vector<uint32_t>&, std::ostream&);
+
+template class InputRowReader<uint8_t>;
+template class InputRowReader<uint16_t>;
+template class InputRowReader<uint32_t>;
@@ -1,24 +1,148 @@
 #pragma once
 
+#include <fstream>
+#include <iostream>
 #include <string>
+#include <vector>
 
 #include "DataContainer.h"
+#include "SummedAreaTableGeneratorFactory.h"
+#include "SyntheticInput.h"
+
+// Program options given as command line arguments
+struct CommandLineOptions
+{
+	std::string input_file;
+	std::string shader_directory;
+	bool print_help{false};
+	// Name of the CPU generator to compare against the reference, or "all"
+	std::string cpu_generator{"all"};
+	CpuGeneratorSettings generator_settings;
+	// Number of bits in the data type: 8, 16 or 32
+	int data_num_of_bits{DEFAULT_DATA_NUM_OF_BITS};
+	// Stream the input row by row to the output file instead of comparing the generators
+	bool stream{false};
+	// Output file of the streaming mode. Empty writes to the standard output
+	std::string output_file;
+	// Binary data file the reference summed area table is written to. Empty doesn't write it
+	std::string binary_output_file;
+	// Directory of the summed area table cache of the reference generator. Empty doesn't use a cache
+	std::string cache_directory;
+	// Maximum size of the cache files in megabytes
+	int cache_size_mb{DEFAULT_CACHE_SIZE_MB};
+	// Generate a synthetic input instead of reading the input file
+	bool synthetic{false};
+	SyntheticInputSettings synthetic_settings;
+	// File the synthetic input is written to, a binary data file with the .satb extension. Empty doesn't write it
+	std::string synthetic_output_file;
+	// Count hardware events of every phase with PerformanceCounters
+	bool performance_counters{false};
+};
 
 // Parser for program and text file inputs for the summed area table
 class InputParser
 {
 public:
 	// Parse the program inputs from the given command line argument list
-	static void parse_command_line_arguments(int argument_count, char* arguments[], std::string& input_file_out, std::string& shader_directory_out, bool& print_help_out);
+	// Will throw a std::runtime_error if an argument has an invalid value
+	static void parse_command_line_arguments(int argument_count, char* arguments[], CommandLineOptions& options_out);
 
 	// Parse the file from input_file into data_out. Can parse text files
 	// with numbers separated by any non-number symbol (comma, space, etc.)
+	// and binary data files with input payloads, which are detected by their header.
+	// The size is only limited by the memory, see max_input_values.
+	// The file is memory mapped and the numbers are parsed in place without allocations.
+	// With more than one thread (0 uses every hardware thread), large files are split into chunks
+	// of whole lines that are parsed in parallel straight into their rows. The messages and errors
+	// are the same as when parsing sequentially.
 	// Will throw a std::runtime_error explaining what went wrong if the
 	// parse isn't successful
-	static void parse_input_file(const std::string& input_file, DataContainer& data_out);
+	template <typename T>
+	static void parse_input_file(const std::string& input_file, DataContainer<T>& data_out, int thread_count = 1);
+
+	// Name of the tokenizer the text parser selected for this CPU: "AVX2", "SSE4.1" or "scalar"
+	static const char* tokenizer_name();
+
+	// Parse the numbers of one text line and append them to values_out. Returns the number of values
+	// in the line. Lines with more than max_width values are an error. Clipped numbers are reported
+	// to message_stream. Will throw a std::runtime_error explaining what went wrong if the parse isn't successful
+	template <typename T>
+	static int parse_line(const char* line_begin, const char* line_end, int current_line, int max_width, std::vector<T>& values_out, std::ostream& message_stream);
+
+	template <typename T>
+	static int parse_line(const std::string& line, int current_line, int max_width, std::vector<T>& values_out, std::ostream& message_stream)
+	{
+		return parse_line(line.data(), line.data() + line.size(), current_line, max_width, values_out, message_stream);
+	}
+
+	// Largest number of input values of type T parse_input_file accepts, a fraction of the physical memory
+	template <typename T>
+	static uint64_t max_input_values();
+private:
+	// Check if the argument is the given option in any of the accepted forms (-f, --f, -file, --file)
+	static bool is_option(const std::string& argument, const std::string& short_name, const std::string& long_name);
+
+	// Parse an integer option value that needs to be at least min_value
+	// Will throw a std::runtime_error if the value is invalid
+	static int parse_integer_option(const std::string& value, const std::string& option_name, int min_value);
+
+	// Parse a size option value, either "WxH" or a single number for a square
+	// Will throw a std::runtime_error if the value is invalid
+	static void parse_size_option(const std::string& value, int& width_out, int& height_out);
+
+	// Copy the input of a binary data file into data_out
+	// Will throw a std::runtime_error if it isn't valid input of type T within the size limits
+	template <typename T>
+	static void parse_binary_file(const std::string& input_file, DataContainer<T>& data_out);
+
+	// Parse the file in chunk_count chunks of whole lines on their own threads
+	template <typename T>
+	static void parse_input_chunks(const char* file_begin, const char* file_end, int chunk_count, DataContainer<T>& data_out);
+
+	// Parse the numbers of one text line, passing each one to output(index, value)
+	template <typename T, typename Output>
+	static int parse_line_values(const char* line_begin, const char* line_end, int current_line, int max_width, Output output, std::ostream& message_stream);
+
+	// Check the width of a parsed line against the first line and the line count against the maximum height
+	// Will throw a std::runtime_error if either doesn't match
+	static void check_line(int current_line, int line_width, int first_line_width, int max_height);
+
+	// Largest number of values in a line and of lines of the given width within max_input_values
+	template <typename T>
+	static int max_input_width();
+	template <typename T>
+	static int max_input_height(int width);
+
+	// Parse the digits of a token. Numbers larger than the maximum of T are clipped to it and reported
+	// to message_stream
+	template <typename T>
+	static T parse_number(const char* token_begin, const char* token_end, int current_line, std::ostream& message_stream);
+
+	// Files smaller than two chunks of this size are parsed sequentially
+	static const size_t PARALLEL_MIN_CHUNK_SIZE = 256 * 1024;
+};
+
+// Reader for text input files one row at a time, so inputs larger than the memory can be streamed.
+// Rows are parsed and validated like parse_input_file does, but without the size limits
+template <typename T>
+class InputRowReader
+{
+public:
+	// Open the input file. Clipped numbers are reported to message_stream
+	// Will throw a std::runtime_error if the file can't be opened
+	explicit InputRowReader(const std::string& input_file, std::ostream& message_stream = std::cout);
+
+	// Read the next row into row_out. Returns false at the end of the file
+	// Will throw a std::runtime_error if the row can't be parsed or has a different width than the first
+	bool read_row(std::vector<T>& row_out);
+
+	// Width of the rows, known after the first row is read
+	int width() const { return mWidth; }
+	int rows_read() const { return mCurrentLine; }
 private:
-	// Parse the given token, and empty it. The number will be added to the given data container.
-	// The current line width will be updated. Will throw a std::runtime_error explaining what went wrong
-	// if the parse isn't successful
-	static void parse_token(std::string& token, DataContainer& data, int& current_line_width, int current_line);
+	std::ifstream mFile;
+	std::ostream& mMessageStream;
+	std::string mLine;
+	int mCurrentLine{0};
+	int mWidth{0};
 };
\ No newline at end of file
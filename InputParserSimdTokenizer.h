@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// SIMD helpers for tokenizing text input. Blocks of bytes are classified into digit masks at
+// once, numbers are found from the mask bits, and runs of up to 8 digits are converted with
+// multiply-adds. AVX2 classifies 32 bytes at a time, SSE4.1 16 bytes.
+// Both are compiled into every x86 build, whatever the compiler targets: GCC and Clang compile
+// the functions below for their instruction set with target attributes, and MSVC allows the
+// intrinsics anyway. tokenizer_path() selects the widest one the CPU supports at runtime. On other
+// architectures SAT_SIMD_TOKENIZER_AVAILABLE is not defined and the parser scans the characters one by one.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define SAT_SIMD_TOKENIZER_AVAILABLE
+#include <immintrin.h>
+#endif
+
+#ifdef SAT_SIMD_TOKENIZER_AVAILABLE
+
+#ifdef _MSC_VER
+#define SAT_TOKENIZER_TARGET_SSE41
+#define SAT_TOKENIZER_TARGET_AVX2
+#define SAT_TOKENIZER_FORCE_INLINE __forceinline
+#else
+#define SAT_TOKENIZER_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SAT_TOKENIZER_TARGET_AVX2 __attribute__((target("avx2")))
+#define SAT_TOKENIZER_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+enum class TokenizerPath
+{
+	Scalar,
+	Sse41,
+	Avx2
+};
+
+inline TokenizerPath detect_tokenizer_path()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	int max_leaf = info[0];
+	__cpuid(info, 1);
+	bool sse41 = (info[2] & (1 << 19)) != 0;
+	// AVX2 also needs the operating system to save the upper halves of the registers
+	bool avx_enabled = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+	bool avx2 = false;
+	if (avx_enabled && max_leaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#else
+	// Also checks that the operating system saves the AVX registers
+	__builtin_cpu_init();
+	bool sse41 = __builtin_cpu_supports("sse4.1");
+	bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+	return avx2 ? TokenizerPath::Avx2 : (sse41 ? TokenizerPath::Sse41 : TokenizerPath::Scalar);
+}
+
+// The widest tokenizer the CPU supports, detected on the first call
+inline TokenizerPath tokenizer_path()
+{
+	static const TokenizerPath path = detect_tokenizer_path();
+	return path;
+}
+
+inline const char* tokenizer_path_name(TokenizerPath path)
+{
+	switch (path)
+	{
+	case TokenizerPath::Avx2:
+		return "AVX2";
+	case TokenizerPath::Sse41:
+		return "SSE4.1";
+	default:
+		return "scalar";
+	}
+}
+
+struct TokenizerAvx2
+{
+	static const int BLOCK_SIZE = 32;
+
+	// Bit i is set if block[i] is a digit
+	SAT_TOKENIZER_TARGET_AVX2 static inline uint32_t digit_mask(const char* block)
+	{
+		__m256i characters = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+		// Digits are the bytes that stay at most 9 after subtracting '0' as unsigned bytes
+		__m256i values = _mm256_sub_epi8(characters, _mm256_set1_epi8('0'));
+		__m256i digits = _mm256_cmpeq_epi8(_mm256_min_epu8(values, _mm256_set1_epi8(9)), values);
+		return static_cast<uint32_t>(_mm256_movemask_epi8(digits));
+	}
+};
+
+struct TokenizerSse41
+{
+	static const int BLOCK_SIZE = 16;
+
+	// Bit i is set if block[i] is a digit
+	SAT_TOKENIZER_TARGET_SSE41 static inline uint32_t digit_mask(const char* block)
+	{
+		__m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+		__m128i values = _mm_sub_epi8(characters, _mm_set1_epi8('0'));
+		__m128i digits = _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+		return static_cast<uint32_t>(_mm_movemask_epi8(digits));
+	}
+};
+
+// Longest digit run converted with SIMD
+static const int TOKENIZER_MAX_SIMD_DIGITS = 8;
+
+// Bytes read by tokenizer_parse_digits from the start of the digits
+static const int TOKENIZER_DIGITS_LOAD_SIZE = 16;
+
+// Index of the lowest set bit. The mask must not be zero
+inline int tokenizer_count_trailing_zeros(uint64_t mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(mask);
+#endif
+}
+
+// Convert the digit_count (1 to 8) digits at digits to their value. Reads TOKENIZER_DIGITS_LOAD_SIZE bytes.
+// Used by both tokenizers, AVX2 includes SSE4.1
+SAT_TOKENIZER_TARGET_SSE41 inline uint32_t tokenizer_parse_digits(const char* digits, int digit_count)
+{
+	// Shuffles moving the digits to the end of the low 8 bytes and zeroing the bytes before them
+	alignas(16) static const int8_t ALIGN_SHUFFLES[TOKENIZER_MAX_SIMD_DIGITS + 1][16] = {
+		{ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+		{ -1, -1, -1, -1, -1, -1, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1 },
+		{ -1, -1, -1, -1, -1, -1, 0, 1, -1, -1, -1, -1, -1, -1, -1, -1 },
+		{ -1, -1, -1, -1, -1, 0, 1, 2, -1, -1, -1, -1, -1, -1, -1, -1 },
+		{ -1, -1, -1, -1, 0, 1, 2, 3, -1, -1, -1, -1, -1, -1, -1, -1 },
+		{ -1, -1, -1, 0, 1, 2, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1 },
+		{ -1, -1, 0, 1, 2, 3, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1 },
+		{ -1, 0, 1, 2, 3, 4, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1 },
+		{ 0, 1, 2, 3, 4, 5, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1 }
+	};
+
+	__m128i values = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)), _mm_set1_epi8('0'));
+	values = _mm_shuffle_epi8(values, _mm_load_si128(reinterpret_cast<const __m128i*>(ALIGN_SHUFFLES[digit_count])));
+
+	// Combine the digits pairwise into 2, 4 and finally 8 digit numbers
+	__m128i pairs = _mm_maddubs_epi16(values, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0, 0, 0, 0, 0));
+	__m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 0, 0, 0, 0));
+	__m128i octet = _mm_madd_epi16(_mm_packus_epi32(quads, quads), _mm_setr_epi16(10000, 1, 0, 0, 0, 0, 0, 0));
+	return static_cast<uint32_t>(_mm_cvtsi128_si32(octet));
+}
+
+#endif // SAT_SIMD_TOKENIZER_AVAILABLE
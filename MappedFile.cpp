@@ -0,0 +1,171 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path, Access access, uint64_t size)
+	: mPath(path)
+	, mAccess(access)
+{
+#ifdef _WIN32
+	bool writable = access == Access::ReadWrite;
+	HANDLE file = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+		writable ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error("Could not open file for mapping: " + path);
+	}
+	mFileHandle = file;
+
+	if (writable)
+	{
+		LARGE_INTEGER file_size;
+		file_size.QuadPart = static_cast<LONGLONG>(size);
+		if (!SetFilePointerEx(file, file_size, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+		{
+			close();
+			throw std::runtime_error("Could not resize file for mapping: " + path);
+		}
+		mSize = size;
+	}
+	else
+	{
+		LARGE_INTEGER file_size;
+		GetFileSizeEx(file, &file_size);
+		mSize = static_cast<uint64_t>(file_size.QuadPart);
+	}
+
+	// Windows can't create a mapping of an empty file
+	if (mSize > 0)
+	{
+		mMappingHandle = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+		if (mMappingHandle == nullptr)
+		{
+			close();
+			throw std::runtime_error("Could not create file mapping: " + path);
+		}
+	}
+#else
+	bool writable = access == Access::ReadWrite;
+	mFileDescriptor = ::open(path.c_str(), writable ? O_RDWR | O_CREAT | O_TRUNC : O_RDONLY, 0644);
+	if (mFileDescriptor < 0)
+	{
+		throw std::runtime_error("Could not open file for mapping: " + path);
+	}
+
+	if (writable)
+	{
+		if (ftruncate(mFileDescriptor, static_cast<off_t>(size)) != 0)
+		{
+			close();
+			throw std::runtime_error("Could not resize file for mapping: " + path);
+		}
+		mSize = size;
+	}
+	else
+	{
+		struct stat file_status;
+		fstat(mFileDescriptor, &file_status);
+		mSize = static_cast<uint64_t>(file_status.st_size);
+	}
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+size_t MappedFile::allocation_granularity()
+{
+#ifdef _WIN32
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+	return system_info.dwAllocationGranularity;
+#else
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+uint8_t* MappedFile::map(uint64_t offset, size_t length)
+{
+	unmap();
+
+	if (length == 0 || offset + length > mSize)
+	{
+		throw std::runtime_error("Mapping outside of the file: " + mPath);
+	}
+
+	uint64_t aligned_offset = offset - offset % allocation_granularity();
+	size_t aligned_length = static_cast<size_t>(offset - aligned_offset) + length;
+
+#ifdef _WIN32
+	DWORD view_access = mAccess == Access::ReadWrite ? FILE_MAP_READ | FILE_MAP_WRITE : FILE_MAP_READ;
+	mMapping = MapViewOfFile(mMappingHandle, view_access, static_cast<DWORD>(aligned_offset >> 32),
+		static_cast<DWORD>(aligned_offset & 0xFFFFFFFF), aligned_length);
+	if (mMapping == nullptr)
+	{
+		throw std::runtime_error("Could not map file: " + mPath);
+	}
+#else
+	int protection = mAccess == Access::ReadWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+	void* mapping = mmap(nullptr, aligned_length, protection, MAP_SHARED, mFileDescriptor, static_cast<off_t>(aligned_offset));
+	if (mapping == MAP_FAILED)
+	{
+		throw std::runtime_error("Could not map file: " + mPath);
+	}
+	mMapping = mapping;
+#endif
+
+	mMappingLength = aligned_length;
+	return static_cast<uint8_t*>(mMapping) + (offset - aligned_offset);
+}
+
+void MappedFile::unmap()
+{
+	if (mMapping == nullptr)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(mMapping);
+#else
+	munmap(mMapping, mMappingLength);
+#endif
+	mMapping = nullptr;
+	mMappingLength = 0;
+}
+
+void MappedFile::close()
+{
+	unmap();
+
+#ifdef _WIN32
+	if (mMappingHandle != nullptr)
+	{
+		CloseHandle(mMappingHandle);
+		mMappingHandle = nullptr;
+	}
+	if (mFileHandle != nullptr)
+	{
+		CloseHandle(mFileHandle);
+		mFileHandle = nullptr;
+	}
+#else
+	if (mFileDescriptor >= 0)
+	{
+		::close(mFileDescriptor);
+		mFileDescriptor = -1;
+	}
+#endif
+}
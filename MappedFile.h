@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Memory mapping of a window of a file, on Windows and POSIX systems
+/// Only one window is mapped at a time, so the memory use stays bounded by the window size
+/// however large the file is. Mapping a new window unmaps the previous one, which writes its
+/// changes back to the file.
+class MappedFile
+{
+public:
+	enum class Access
+	{
+		Read,
+		// Create the file or truncate it to the given size
+		ReadWrite
+	};
+
+	// Open the file for mapping. ReadWrite creates or resizes the file to size bytes
+	// Will throw std::runtime_error if the file can't be opened or resized
+	MappedFile(const std::string& path, Access access, uint64_t size = 0);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Map the bytes [offset, offset + length) of the file and return their address. The range is
+	// extended to the allocation granularity internally. Unmaps the previous window
+	// Will throw std::runtime_error if the range is outside the file or can't be mapped
+	uint8_t* map(uint64_t offset, size_t length);
+
+	// Unmap the current window, writing its changes back to the file
+	void unmap();
+
+	uint64_t size() const { return mSize; }
+
+	// Alignment the offset of a mapping needs on this system
+	static size_t allocation_granularity();
+private:
+	void close();
+
+	std::string mPath;
+	Access mAccess;
+	uint64_t mSize{0};
+
+	// The mapped window including the alignment before the requested offset
+	void* mMapping{nullptr};
+	size_t mMappingLength{0};
+
+#ifdef _WIN32
+	void* mFileHandle{nullptr};
+	void* mMappingHandle{nullptr};
+#else
+	int mFileDescriptor{-1};
+#endif
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "constants.h"
+
+// How summed area table values larger than the data type maximum are stored
+enum class OverflowMode
+{
+	// Clamp to the maximum value. Box sums are only exact while the bottom right corner isn't clamped
+	Saturate,
+	// Store the sums modulo 2^bits. Any box sum whose true value fits in the data type is still exact
+	// when computed with unsigned wraparound (D - B - C + A), so the table can keep the input precision
+	Wrap
+};
+
+// Reduce a sum of values of T to the range of T according to the overflow mode.
+// Accumulator is the type the sum is computed in, and needs to be wider than T for saturation
+template <typename T, OverflowMode Mode, typename Accumulator>
+inline Accumulator reduce_sum(Accumulator sum)
+{
+	if constexpr (Mode == OverflowMode::Saturate)
+	{
+		return std::min<Accumulator>(sum, static_cast<Accumulator>(DATA_MAX_VALUE<T>));
+	}
+	else
+	{
+		return static_cast<T>(sum);
+	}
+}
+
+// Call function with std::integral_constant<OverflowMode, mode>, so the hot loops can be
+// instantiated for the mode selected at runtime:
+// dispatch_overflow_mode(mode, [&](auto mode_tag) { kernel<T, decltype(mode_tag)::value>(...); });
+template <typename Function>
+auto dispatch_overflow_mode(OverflowMode mode, Function&& function)
+{
+	if (mode == OverflowMode::Wrap)
+	{
+		return function(std::integral_constant<OverflowMode, OverflowMode::Wrap>{});
+	}
+	return function(std::integral_constant<OverflowMode, OverflowMode::Saturate>{});
+}
+
+inline std::string overflow_mode_name(OverflowMode mode)
+{
+	return mode == OverflowMode::Wrap ? "wrap" : "saturate";
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Resolve a requested thread count, where 0 means "use every hardware thread"
+inline int resolve_thread_count(int requested_thread_count)
+{
+	if (requested_thread_count > 0)
+	{
+		return requested_thread_count;
+	}
+	return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// Split the index range [0, count) into contiguous blocks and run function(begin, end)
+// for each block on its own thread. The calling thread processes the last block itself.
+// Blocks are never empty, so fewer threads are used if count is small.
+template <typename Function>
+void parallel_for(int count, int thread_count, Function function)
+{
+	thread_count = std::min(resolve_thread_count(thread_count), count);
+	if (thread_count <= 1)
+	{
+		if (count > 0)
+		{
+			function(0, count);
+		}
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count - 1);
+
+	int block_size = count / thread_count;
+	int remainder = count % thread_count;
+	int begin = 0;
+
+	for (int i = 0; i < thread_count; ++i)
+	{
+		// Spread the remainder over the first blocks so the work stays balanced
+		int end = begin + block_size + (i < remainder ? 1 : 0);
+		if (i == thread_count - 1)
+		{
+			function(begin, end);
+		}
+		else
+		{
+			threads.emplace_back(function, begin, end);
+		}
+		begin = end;
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
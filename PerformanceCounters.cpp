@@ -0,0 +1,106 @@
+#include "PerformanceCounters.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+thread_local PerformanceCounters* PerformanceCounters::mActive = nullptr;
+
+#ifdef __linux__
+struct CounterEvent
+{
+	uint64_t config;
+	const char* name;
+};
+
+// In the order of the CounterValues fields. The generic cache miss event counts last level cache misses
+static const CounterEvent COUNTER_EVENTS[] = {
+	{ PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+	{ PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+	{ PERF_COUNT_HW_CACHE_MISSES, "LLC misses" },
+	{ PERF_COUNT_HW_BRANCH_MISSES, "branch misses" },
+};
+#endif
+
+PerformanceCounters::PerformanceCounters()
+{
+	for (int& file_descriptor : mFileDescriptors)
+	{
+		file_descriptor = -1;
+	}
+
+#ifdef __linux__
+	for (int i = 0; i < COUNTER_COUNT; ++i)
+	{
+		perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.config = COUNTER_EVENTS[i].config;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		// With more events than hardware counters the kernel multiplexes them, so every count comes
+		// with the time it was enabled and the time it actually ran to scale it by
+		attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		// Also count the threads of the parallel generators and parser, which are started later.
+		// The counts of an inherited thread are only added when it exits, so the persistent workers
+		// of the ThreadPool in SummedAreaTableBatchGenerator aren't counted while the pool lives
+		attributes.inherit = 1;
+
+		// The calling thread on any CPU
+		long file_descriptor = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+		if (file_descriptor < 0)
+		{
+			mUnavailableReason = std::string("Could not open the ") + COUNTER_EVENTS[i].name + " counter: " + strerror(errno);
+			if (errno == EACCES || errno == EPERM)
+			{
+				mUnavailableReason += ". Lowering /proc/sys/kernel/perf_event_paranoid to 2 or less allows counting user space code";
+			}
+			break;
+		}
+		mFileDescriptors[i] = static_cast<int>(file_descriptor);
+	}
+	mAvailable = mUnavailableReason.empty();
+#else
+	mUnavailableReason = "Performance counters are only supported on Linux";
+#endif
+}
+
+PerformanceCounters::~PerformanceCounters()
+{
+#ifdef __linux__
+	for (int file_descriptor : mFileDescriptors)
+	{
+		if (file_descriptor >= 0)
+		{
+			close(file_descriptor);
+		}
+	}
+#endif
+}
+
+CounterValues PerformanceCounters::read() const
+{
+	uint64_t values[COUNTER_COUNT] = {};
+#ifdef __linux__
+	if (mAvailable)
+	{
+		for (int i = 0; i < COUNTER_COUNT; ++i)
+		{
+			// The count, the time enabled and the time running
+			uint64_t data[3];
+			if (::read(mFileDescriptors[i], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+			{
+				continue;
+			}
+			// Extrapolate a multiplexed count to the whole time enabled
+			values[i] = data[2] < data[1] ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]) : data[0];
+		}
+	}
+#endif
+	return { values[0], values[1], values[2], values[3] };
+}
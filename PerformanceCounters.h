@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Hardware event counts of a piece of code
+struct CounterValues
+{
+	uint64_t cycles{0};
+	uint64_t instructions{0};
+	// Last level cache misses
+	uint64_t llc_misses{0};
+	uint64_t branch_misses{0};
+
+	// Instructions per cycle
+	double ipc() const { return cycles > 0 ? static_cast<double>(instructions) / cycles : 0.0; }
+
+	CounterValues& operator+=(const CounterValues& other)
+	{
+		cycles += other.cycles;
+		instructions += other.instructions;
+		llc_misses += other.llc_misses;
+		branch_misses += other.branch_misses;
+		return *this;
+	}
+
+	CounterValues operator-(const CounterValues& other) const
+	{
+		return { cycles - other.cycles, instructions - other.instructions, llc_misses - other.llc_misses, branch_misses - other.branch_misses };
+	}
+};
+
+/// Hardware performance counters of the thread that opens them and the threads it starts afterwards,
+/// read with the Linux perf_event_open system call. Only user space code is counted.
+/// On other platforms, or without access to the counters (see /proc/sys/kernel/perf_event_paranoid),
+/// the counters are unavailable and read zeros, so profiling stays optional.
+/// While counters are active on a thread (see ActivePerformanceCounters), every PhaseTimer on that
+/// thread adds the counts of its phases to its TimingReport.
+class PerformanceCounters
+{
+public:
+	// Open and start the counters. Doesn't throw if they are unavailable
+	PerformanceCounters();
+	~PerformanceCounters();
+
+	// Not copyable or movable, the active counters are referenced by address
+	PerformanceCounters(const PerformanceCounters&) = delete;
+	PerformanceCounters& operator=(const PerformanceCounters&) = delete;
+
+	bool available() const { return mAvailable; }
+	// Why the counters are unavailable, empty if they are available
+	const std::string& unavailable_reason() const { return mUnavailableReason; }
+
+	// Counts since the counters were opened. Threads started after opening are included once they have exited.
+	// Counts of events the kernel multiplexed are scaled up to the whole time they were enabled
+	CounterValues read() const;
+
+	// The counters active on the calling thread, or nullptr
+	static PerformanceCounters* active() { return mActive; }
+private:
+	friend class ActivePerformanceCounters;
+
+	static const int COUNTER_COUNT = 4;
+	int mFileDescriptors[COUNTER_COUNT];
+	bool mAvailable{false};
+	std::string mUnavailableReason;
+
+	static thread_local PerformanceCounters* mActive;
+};
+
+/// Makes the counters active on the calling thread for the lifetime of this object,
+/// so the PhaseTimers of the code it wraps report them. Unavailable counters aren't activated
+class ActivePerformanceCounters
+{
+public:
+	explicit ActivePerformanceCounters(PerformanceCounters* counters)
+		: mPrevious(PerformanceCounters::mActive)
+	{
+		if (counters != nullptr && counters->available())
+		{
+			PerformanceCounters::mActive = counters;
+		}
+	}
+	~ActivePerformanceCounters() { PerformanceCounters::mActive = mPrevious; }
+
+	ActivePerformanceCounters(const ActivePerformanceCounters&) = delete;
+	ActivePerformanceCounters& operator=(const ActivePerformanceCounters&) = delete;
+private:
+	PerformanceCounters* mPrevious;
+};
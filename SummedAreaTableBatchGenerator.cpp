@@ -0,0 +1,258 @@
+#include "SummedAreaTableBatchGenerator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "constants.h"
+#include "SummedAreaTableSimdKernels.h"
+
+double BatchReport::mpixels_per_second() const
+{
+	return element_count / (std::max(timing.total_milliseconds(), 0.001f) * 1000.0);
+}
+
+double BatchReport::images_per_second() const
+{
+	return image_count / (std::max(timing.total_milliseconds(), 0.001f) / 1000.0);
+}
+
+// Generate the summed area table of the rows [row_begin, row_end) as if they were a whole image
+template <typename T, OverflowMode Mode>
+static void generate_band(const T* input, T* output, int width, int row_begin, int row_end)
+{
+	for (int y = row_begin; y < row_end; ++y)
+	{
+		const T* input_row = input + static_cast<size_t>(y) * width;
+		T* output_row = output + static_cast<size_t>(y) * width;
+		const T* previous_output_row = y > row_begin ? output_row - width : nullptr;
+
+		summed_area_table_row<T, Mode>(input_row, previous_output_row, output_row, width);
+	}
+}
+
+// Add the carry row to every row in [row_begin, row_end). Clamping the band sums first gives the
+// same result as the reference, since min(min(a, max) + b, max) == min(a + b, max) for unsigned values
+template <typename T, OverflowMode Mode>
+static void add_carry(const T* carry, T* output, int width, int row_begin, int row_end)
+{
+	for (int y = row_begin; y < row_end; ++y)
+	{
+		T* output_row = output + static_cast<size_t>(y) * width;
+		for (int x = 0; x < width; ++x)
+		{
+			output_row[x] = static_cast<T>(reduce_sum<T, Mode>(static_cast<uint64_t>(output_row[x]) + carry[x]));
+		}
+	}
+}
+
+template <typename T>
+SummedAreaTableBatchGenerator<T>::SummedAreaTableBatchGenerator(int thread_count, size_t large_image_elements)
+	: mPool(thread_count)
+	, mLargeImageElements(large_image_elements)
+{
+}
+
+template <typename T>
+std::vector<int> SummedAreaTableBatchGenerator<T>::split_bands(int height) const
+{
+	int band_count = std::min(mPool.thread_count(), height);
+	std::vector<int> band_begins(band_count + 1);
+	for (int band = 0; band <= band_count; ++band)
+	{
+		band_begins[band] = static_cast<int>(static_cast<int64_t>(height) * band / band_count);
+	}
+	return band_begins;
+}
+
+template <typename T>
+void SummedAreaTableBatchGenerator<T>::classify_images(std::span<const DataContainer<T>> inputs, size_t output_count, BatchReport& report,
+	std::vector<int>& small_images, std::vector<int>& large_images) const
+{
+	if (inputs.size() != output_count)
+	{
+		throw std::runtime_error("The batch has " + std::to_string(inputs.size()) + " inputs but " + std::to_string(output_count) + " outputs");
+	}
+
+	report.image_count = inputs.size();
+	for (size_t i = 0; i < inputs.size(); ++i)
+	{
+		report.element_count += inputs[i].data.size();
+		(inputs[i].data.size() >= mLargeImageElements ? large_images : small_images).push_back(static_cast<int>(i));
+	}
+}
+
+template <typename T>
+template <OverflowMode Mode>
+void SummedAreaTableBatchGenerator<T>::generate_large(const DataContainer<T>& data_in, DataContainer<T>& data_out)
+{
+	int width = data_in.width;
+	int height = data_in.height;
+	const T* input = data_in.data.data();
+	T* output = data_out.data.data();
+	if (width == 0 || height == 0)
+	{
+		return;
+	}
+
+	std::vector<int> band_begins = split_bands(height);
+	int band_count = static_cast<int>(band_begins.size()) - 1;
+
+	mPool.run(band_count, [&](int band)
+	{
+		generate_band<T, Mode>(input, output, width, band_begins[band], band_begins[band + 1]);
+	});
+
+	// The final last row of every band is its own last row plus the final last row of the band above.
+	// Only these rows are carried sequentially, the rest of the bands are then fixed up in parallel
+	std::vector<T> carries(static_cast<size_t>(band_count) * width);
+	for (int band = 1; band < band_count; ++band)
+	{
+		T* carry = carries.data() + static_cast<size_t>(band) * width;
+		const T* previous_last_row = output + static_cast<size_t>(band_begins[band] - 1) * width;
+		std::copy(previous_last_row, previous_last_row + width, carry);
+		if (band > 1)
+		{
+			add_carry<T, Mode>(carry - width, carry, width, 0, 1);
+		}
+	}
+
+	mPool.run(band_count - 1, [&](int task)
+	{
+		int band = task + 1;
+		add_carry<T, Mode>(carries.data() + static_cast<size_t>(band) * width, output, width, band_begins[band], band_begins[band + 1]);
+	});
+}
+
+template <typename T>
+BatchReport SummedAreaTableBatchGenerator<T>::generate(std::span<const DataContainer<T>> inputs, std::span<DataContainer<T>> outputs)
+{
+	BatchReport report;
+	PhaseTimer timer(report.timing);
+
+	std::vector<int> small_images;
+	std::vector<int> large_images;
+	classify_images(inputs, outputs.size(), report, small_images, large_images);
+
+	// The large outputs are allocated up front, the small ones by the thread generating them
+	for (int image : large_images)
+	{
+		outputs[image].data.resize(inputs[image].data.size());
+		outputs[image].width = inputs[image].width;
+		outputs[image].height = inputs[image].height;
+	}
+	timer.lap(TIMING_PHASE_ALLOCATE);
+
+	dispatch_overflow_mode(mOverflowMode, [&](auto mode_tag)
+	{
+		constexpr OverflowMode Mode = decltype(mode_tag)::value;
+
+		mPool.run(static_cast<int>(small_images.size()), [&](int task)
+		{
+			const DataContainer<T>& data_in = inputs[small_images[task]];
+			DataContainer<T>& data_out = outputs[small_images[task]];
+			data_out.data.resize(data_in.data.size());
+			data_out.width = data_in.width;
+			data_out.height = data_in.height;
+			generate_band<T, Mode>(data_in.data.data(), data_out.data.data(), data_in.width, 0, data_in.height);
+		});
+
+		for (int image : large_images)
+		{
+			generate_large<Mode>(inputs[image], outputs[image]);
+		}
+	});
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
+}
+
+template <typename T>
+void SummedAreaTableBatchGenerator<T>::generate_large_statistics(const DataContainer<T>& data_in, StatisticsTables& tables_out)
+{
+	int width = data_in.width;
+	if (width == 0 || data_in.height == 0)
+	{
+		return;
+	}
+
+	SummedAreaTableStatisticsGenerator<T> generator;
+	std::vector<int> band_begins = split_bands(data_in.height);
+	int band_count = static_cast<int>(band_begins.size()) - 1;
+
+	mPool.run(band_count, [&](int band)
+	{
+		generator.generate_rows(data_in, tables_out, band_begins[band], band_begins[band + 1]);
+	});
+
+	// Carry the final last rows of the bands down like generate_large(). The tables wrap around, so the carries just add
+	std::vector<uint64_t> sum_carries(static_cast<size_t>(band_count) * width);
+	std::vector<uint64_t> square_carries(sum_carries.size());
+	for (int band = 1; band < band_count; ++band)
+	{
+		size_t carry_offset = static_cast<size_t>(band) * width;
+		size_t last_row_offset = static_cast<size_t>(band_begins[band] - 1) * width;
+		for (int x = 0; x < width; ++x)
+		{
+			uint64_t previous_sum = band > 1 ? sum_carries[carry_offset - width + x] : 0;
+			uint64_t previous_square = band > 1 ? square_carries[carry_offset - width + x] : 0;
+			sum_carries[carry_offset + x] = tables_out.sums[last_row_offset + x] + previous_sum;
+			square_carries[carry_offset + x] = tables_out.squared_sums[last_row_offset + x] + previous_square;
+		}
+	}
+
+	mPool.run(band_count - 1, [&](int task)
+	{
+		int band = task + 1;
+		const uint64_t* sum_carry = sum_carries.data() + static_cast<size_t>(band) * width;
+		const uint64_t* square_carry = square_carries.data() + static_cast<size_t>(band) * width;
+		for (int y = band_begins[band]; y < band_begins[band + 1]; ++y)
+		{
+			uint64_t* sums_row = tables_out.sums.data() + static_cast<size_t>(y) * width;
+			uint64_t* squares_row = tables_out.squared_sums.data() + static_cast<size_t>(y) * width;
+			for (int x = 0; x < width; ++x)
+			{
+				sums_row[x] += sum_carry[x];
+				squares_row[x] += square_carry[x];
+			}
+		}
+	});
+}
+
+template <typename T>
+BatchReport SummedAreaTableBatchGenerator<T>::generate_statistics(std::span<const DataContainer<T>> inputs, std::span<StatisticsTables> outputs)
+{
+	BatchReport report;
+	PhaseTimer timer(report.timing);
+
+	std::vector<int> small_images;
+	std::vector<int> large_images;
+	classify_images(inputs, outputs.size(), report, small_images, large_images);
+
+	for (int image : large_images)
+	{
+		outputs[image].sums.resize(inputs[image].data.size());
+		outputs[image].squared_sums.resize(inputs[image].data.size());
+		outputs[image].width = inputs[image].width;
+		outputs[image].height = inputs[image].height;
+	}
+	timer.lap(TIMING_PHASE_ALLOCATE);
+
+	SummedAreaTableStatisticsGenerator<T> generator;
+	mPool.run(static_cast<int>(small_images.size()), [&](int task)
+	{
+		generator.generate(inputs[small_images[task]], outputs[small_images[task]]);
+	});
+
+	for (int image : large_images)
+	{
+		generate_large_statistics(inputs[image], outputs[image]);
+	}
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
+}
+
+template class SummedAreaTableBatchGenerator<uint8_t>;
+template class SummedAreaTableBatchGenerator<uint16_t>;
+template class SummedAreaTableBatchGenerator<uint32_t>;
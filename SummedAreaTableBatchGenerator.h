@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "DataContainer.h"
+#include "OverflowMode.h"
+#include "SummedAreaTableStatisticsGenerator.h"
+#include "ThreadPool.h"
+#include "TimingReport.h"
+
+// Timing and throughput of a batch
+struct BatchReport
+{
+	// Wall clock phases of the whole batch. Small images allocate their output inside TIMING_PHASE_COMPUTE
+	TimingReport timing;
+	size_t image_count{0};
+	uint64_t element_count{0};
+
+	// Millions of elements per second over all images
+	double mpixels_per_second() const;
+	double images_per_second() const;
+};
+
+/// Generates the summed area tables of many images at once on a ThreadPool
+/// Small images are generated one image per task with the SIMD row kernel, so the pool keeps
+/// every core busy with whole images. Images with at least the large image threshold of elements
+/// are generated one at a time, split into bands of rows between the threads: every band is
+/// generated on its own, and then the last row of the bands above is added to it.
+template <typename T>
+class SummedAreaTableBatchGenerator
+{
+public:
+	// Create the generator with the given number of threads, 0 uses every hardware thread
+	explicit SummedAreaTableBatchGenerator(int thread_count = 0, size_t large_image_elements = DEFAULT_LARGE_IMAGE_ELEMENTS);
+
+	// Generate the summed area table of every input into the output at the same index
+	// Will throw a std::runtime_error if the number of inputs and outputs differ
+	BatchReport generate(std::span<const DataContainer<T>> inputs, std::span<DataContainer<T>> outputs);
+
+	// Generate the sum and squared sum tables of every input into the tables at the same index, scheduled
+	// like generate() with the SIMD kernel of SummedAreaTableStatisticsGenerator
+	// Will throw a std::runtime_error if the number of inputs and outputs differ
+	BatchReport generate_statistics(std::span<const DataContainer<T>> inputs, std::span<StatisticsTables> outputs);
+
+	void set_overflow_mode(OverflowMode mode) { mOverflowMode = mode; }
+	OverflowMode get_overflow_mode() const { return mOverflowMode; }
+
+	int thread_count() const { return mPool.thread_count(); }
+
+	// 1024 x 1024, where splitting an image starts to pay off over running images side by side
+	static const size_t DEFAULT_LARGE_IMAGE_ELEMENTS = 1024 * 1024;
+private:
+	template <OverflowMode Mode>
+	void generate_large(const DataContainer<T>& data_in, DataContainer<T>& data_out);
+
+	void generate_large_statistics(const DataContainer<T>& data_in, StatisticsTables& tables_out);
+
+	// Split the rows into one band per thread, returning the first row of every band and the end of the last one
+	std::vector<int> split_bands(int height) const;
+
+	// Sort the images into the small and large ones, and add them to the report
+	void classify_images(std::span<const DataContainer<T>> inputs, size_t output_count, BatchReport& report,
+		std::vector<int>& small_images, std::vector<int>& large_images) const;
+
+	ThreadPool mPool;
+	size_t mLargeImageElements;
+	OverflowMode mOverflowMode{OverflowMode::Saturate};
+};
@@ -0,0 +1,293 @@
+#include "SummedAreaTableCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+static const uint64_t XXH_PRIME_1 = 11400714785074694791ull;
+static const uint64_t XXH_PRIME_2 = 14029467366897019727ull;
+static const uint64_t XXH_PRIME_3 = 1609587929392839161ull;
+static const uint64_t XXH_PRIME_4 = 9650029242287828579ull;
+static const uint64_t XXH_PRIME_5 = 2870177450012600261ull;
+
+static const uint64_t SPLITMIX_INCREMENT = 0x9e3779b97f4a7c15ull;
+
+// Extension of the cache files, so other files in the directory are never evicted
+static const char* CACHE_FILE_EXTENSION = ".satb";
+
+static uint64_t rotate_left(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t read_word(const uint8_t* bytes)
+{
+	uint64_t word;
+	memcpy(&word, bytes, sizeof(word));
+	return word;
+}
+
+static uint64_t xxh64_round(uint64_t accumulator, uint64_t word)
+{
+	accumulator += word * XXH_PRIME_2;
+	return rotate_left(accumulator, 31) * XXH_PRIME_1;
+}
+
+static uint64_t xxh64_merge_round(uint64_t hash, uint64_t accumulator)
+{
+	hash ^= xxh64_round(0, accumulator);
+	return hash * XXH_PRIME_1 + XXH_PRIME_4;
+}
+
+// XXH64 of the bytes with the seed. Four independent lanes consume 32 bytes per step, and the final
+// avalanche makes every input bit affect every output bit
+static uint64_t xxh64(uint64_t seed, const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	const uint8_t* end = bytes + size;
+	uint64_t hash;
+
+	if (size >= 32)
+	{
+		uint64_t lanes[4] = { seed + XXH_PRIME_1 + XXH_PRIME_2, seed + XXH_PRIME_2, seed, seed - XXH_PRIME_1 };
+		for (; end - bytes >= 32; bytes += 32)
+		{
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				lanes[lane] = xxh64_round(lanes[lane], read_word(bytes + lane * sizeof(uint64_t)));
+			}
+		}
+		hash = rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7) + rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18);
+		for (uint64_t lane : lanes)
+		{
+			hash = xxh64_merge_round(hash, lane);
+		}
+	}
+	else
+	{
+		hash = seed + XXH_PRIME_5;
+	}
+	hash += size;
+
+	for (; end - bytes >= 8; bytes += 8)
+	{
+		hash ^= xxh64_round(0, read_word(bytes));
+		hash = rotate_left(hash, 27) * XXH_PRIME_1 + XXH_PRIME_4;
+	}
+	if (end - bytes >= 4)
+	{
+		uint32_t word;
+		memcpy(&word, bytes, sizeof(word));
+		hash ^= word * XXH_PRIME_1;
+		hash = rotate_left(hash, 23) * XXH_PRIME_2 + XXH_PRIME_3;
+		bytes += 4;
+	}
+	for (; bytes < end; ++bytes)
+	{
+		hash ^= *bytes * XXH_PRIME_5;
+		hash = rotate_left(hash, 11) * XXH_PRIME_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= XXH_PRIME_2;
+	hash ^= hash >> 29;
+	hash *= XXH_PRIME_3;
+	return hash ^ (hash >> 32);
+}
+
+// The splitmix64 finalizer, a bijection where every input bit affects every output bit
+static uint64_t splitmix64_mix(uint64_t value)
+{
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+	return value ^ (value >> 31);
+}
+
+// Digest of the bytes continuing from digest, built differently from XXH64 so a collision of one is
+// no collision of the other: every word is mixed with its position on its own before it's combined
+static uint64_t digest_bytes(uint64_t digest, const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	size_t word_count = size / sizeof(uint64_t);
+	for (size_t i = 0; i < word_count; ++i)
+	{
+		digest = rotate_left(digest, 29) ^ splitmix64_mix(read_word(bytes + i * sizeof(uint64_t)) + (i + 1) * SPLITMIX_INCREMENT);
+	}
+	uint64_t tail = 0;
+	size_t tail_size = size - word_count * sizeof(uint64_t);
+	if (tail_size > 0)
+	{
+		memcpy(&tail, bytes + word_count * sizeof(uint64_t), tail_size);
+	}
+	digest = rotate_left(digest, 29) ^ splitmix64_mix(tail + (word_count + 1) * SPLITMIX_INCREMENT);
+	return splitmix64_mix(digest ^ size);
+}
+
+SummedAreaTableCache::SummedAreaTableCache(const std::string& directory, uint64_t max_size)
+	: mDirectory(directory)
+	, mMaxSize(max_size)
+{
+	std::error_code error;
+	std::filesystem::create_directories(mDirectory, error);
+	if (!std::filesystem::is_directory(mDirectory))
+	{
+		throw std::runtime_error("Could not create the cache directory: " + directory);
+	}
+}
+
+template <typename T>
+CacheKey SummedAreaTableCache::key(const DataContainer<T>& input, const std::string& generator_name, OverflowMode mode)
+{
+	uint64_t properties[] = { static_cast<uint64_t>(input.width), static_cast<uint64_t>(input.height),
+		static_cast<uint64_t>(DATA_NUM_OF_BITS<T>), static_cast<uint64_t>(mode) };
+	size_t data_size = input.data.size() * sizeof(T);
+
+	// Every part seeds the hash of the next one
+	CacheKey key;
+	key.hash = xxh64(0, properties, sizeof(properties));
+	key.hash = xxh64(key.hash, generator_name.data(), generator_name.size());
+	key.hash = xxh64(key.hash, input.data.data(), data_size);
+
+	key.digest = digest_bytes(0, properties, sizeof(properties));
+	key.digest = digest_bytes(key.digest, generator_name.data(), generator_name.size());
+	key.digest = digest_bytes(key.digest, input.data.data(), data_size);
+	return key;
+}
+
+std::filesystem::path SummedAreaTableCache::file_path(uint64_t key) const
+{
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+	return mDirectory / (std::string(name) + CACHE_FILE_EXTENSION);
+}
+
+template <typename T>
+std::unique_ptr<MappedDataView<T>> SummedAreaTableCache::map(const CacheKey& key, int width, int height)
+{
+	std::filesystem::path path = file_path(key.hash);
+	std::unique_ptr<MappedDataView<T>> view;
+	if (std::filesystem::exists(path))
+	{
+		// Damaged files and files of another type, size or input digest are misses
+		try
+		{
+			view = std::make_unique<MappedDataView<T>>(path.string());
+		}
+		catch (const std::runtime_error&)
+		{
+		}
+	}
+
+	if (view == nullptr || view->payload() != BinaryPayload::SummedAreaTable || view->width() != width || view->height() != height
+		|| view->digest() != key.digest)
+	{
+		++mStatistics.misses;
+		return nullptr;
+	}
+
+	// Mark the file as recently used
+	std::error_code error;
+	std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+	++mStatistics.hits;
+	return view;
+}
+
+template <typename T>
+bool SummedAreaTableCache::load(const CacheKey& key, int width, int height, DataContainer<T>& table_out)
+{
+	std::unique_ptr<MappedDataView<T>> view = map<T>(key, width, height);
+	if (view == nullptr)
+	{
+		return false;
+	}
+	view->copy_to(table_out);
+	return true;
+}
+
+template <typename T>
+void SummedAreaTableCache::store(const CacheKey& key, const DataContainer<T>& table)
+{
+	// Write to a temporary file first, so other processes never map a partially written table
+	std::filesystem::path path = file_path(key.hash);
+	std::filesystem::path temporary_path = path;
+	temporary_path += ".tmp";
+	BinaryDataFile::write(temporary_path.string(), table, BinaryPayload::SummedAreaTable, BinaryDataFile::DEFAULT_ROW_ALIGNMENT, key.digest);
+
+	std::error_code error;
+	std::filesystem::rename(temporary_path, path, error);
+	if (error)
+	{
+		std::filesystem::remove(temporary_path, error);
+		throw std::runtime_error("Could not store the table in the cache: " + path.string());
+	}
+
+	evict();
+}
+
+uint64_t SummedAreaTableCache::size() const
+{
+	uint64_t total_size = 0;
+	std::error_code error;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(mDirectory, error))
+	{
+		if (entry.is_regular_file(error) && entry.path().extension() == CACHE_FILE_EXTENSION)
+		{
+			total_size += entry.file_size(error);
+		}
+	}
+	return total_size;
+}
+
+void SummedAreaTableCache::evict()
+{
+	struct CacheFile
+	{
+		std::filesystem::path path;
+		std::filesystem::file_time_type last_use;
+		uint64_t size;
+	};
+
+	std::vector<CacheFile> files;
+	uint64_t total_size = 0;
+	std::error_code error;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(mDirectory, error))
+	{
+		if (entry.is_regular_file(error) && entry.path().extension() == CACHE_FILE_EXTENSION)
+		{
+			files.push_back({ entry.path(), entry.last_write_time(error), entry.file_size(error) });
+			total_size += files.back().size;
+		}
+	}
+
+	std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b)
+	{
+		return a.last_use < b.last_use;
+	});
+
+	for (size_t i = 0; i < files.size() && total_size > mMaxSize; ++i)
+	{
+		if (std::filesystem::remove(files[i].path, error))
+		{
+			total_size -= files[i].size;
+			++mStatistics.evictions;
+		}
+	}
+}
+
+template CacheKey SummedAreaTableCache::key<uint8_t>(const DataContainer<uint8_t>&, const std::string&, OverflowMode);
+template CacheKey SummedAreaTableCache::key<uint16_t>(const DataContainer<uint16_t>&, const std::string&, OverflowMode);
+template CacheKey SummedAreaTableCache::key<uint32_t>(const DataContainer<uint32_t>&, const std::string&, OverflowMode);
+
+template std::unique_ptr<MappedDataView<uint8_t>> SummedAreaTableCache::map<uint8_t>(const CacheKey&, int, int);
+template std::unique_ptr<MappedDataView<uint16_t>> SummedAreaTableCache::map<uint16_t>(const CacheKey&, int, int);
+template std::unique_ptr<MappedDataView<uint32_t>> SummedAreaTableCache::map<uint32_t>(const CacheKey&, int, int);
+
+template bool SummedAreaTableCache::load<uint8_t>(const CacheKey&, int, int, DataContainer<uint8_t>&);
+template bool SummedAreaTableCache::load<uint16_t>(const CacheKey&, int, int, DataContainer<uint16_t>&);
+template bool SummedAreaTableCache::load<uint32_t>(const CacheKey&, int, int, DataContainer<uint32_t>&);
+
+template void SummedAreaTableCache::store<uint8_t>(const CacheKey&, const DataContainer<uint8_t>&);
+template void SummedAreaTableCache::store<uint16_t>(const CacheKey&, const DataContainer<uint16_t>&);
+template void SummedAreaTableCache::store<uint32_t>(const CacheKey&, const DataContainer<uint32_t>&);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "BinaryDataFile.h"
+#include "DataContainer.h"
+#include "OverflowMode.h"
+
+// Counters of the cache lookups and evictions since the cache was opened
+struct CacheStatistics
+{
+	uint64_t hits{0};
+	uint64_t misses{0};
+	uint64_t evictions{0};
+};
+
+// Key of a cached table: the hash naming its file, and an independent digest of the same data stored
+// in the file header, so a hit is only trusted when both match
+struct CacheKey
+{
+	uint64_t hash{0};
+	uint64_t digest{0};
+};
+
+/// Content-addressed on-disk cache of summed area tables
+/// Tables are stored as binary data files named by an XXH64 hash of everything the result depends on: the
+/// input dimensions, element type and data, the generator and the overflow mode. A hit is memory
+/// mapped from the file instead of generated. When the files take more than the maximum size, the
+/// least recently used ones are removed, using the file modification times, which hits refresh.
+class SummedAreaTableCache
+{
+public:
+	// Use the directory for the cache files, creating it if it doesn't exist
+	// Will throw std::runtime_error if the directory can't be created
+	explicit SummedAreaTableCache(const std::string& directory, uint64_t max_size = DEFAULT_MAX_SIZE);
+
+	// Key of the table the named generator computes from the input in the given overflow mode
+	template <typename T>
+	static CacheKey key(const DataContainer<T>& input, const std::string& generator_name, OverflowMode mode);
+
+	// Map the table cached under the key. Returns nullptr on a miss
+	// A file of other dimensions than the expected ones or with another digest is a miss
+	template <typename T>
+	std::unique_ptr<MappedDataView<T>> map(const CacheKey& key, int width, int height);
+
+	// Copy the table cached under the key into table_out. Returns false on a miss, like map()
+	template <typename T>
+	bool load(const CacheKey& key, int width, int height, DataContainer<T>& table_out);
+
+	// Store the table under the key and evict the least recently used tables over the maximum size
+	// Will throw std::runtime_error if the file can't be written
+	template <typename T>
+	void store(const CacheKey& key, const DataContainer<T>& table);
+
+	// Total size of the cached table files in bytes
+	uint64_t size() const;
+
+	const CacheStatistics& statistics() const { return mStatistics; }
+
+	static const uint64_t DEFAULT_MAX_SIZE = 1024ull * 1024 * 1024;
+private:
+	std::filesystem::path file_path(uint64_t key) const;
+
+	// Remove the least recently used files until the cache fits in the maximum size
+	void evict();
+
+	std::filesystem::path mDirectory;
+	uint64_t mMaxSize;
+	CacheStatistics mStatistics;
+};
@@ -1,16 +1,25 @@
 ﻿#pragma once
 
-#include <chrono>
-
 #include "DataContainer.h"
+#include "OverflowMode.h"
+#include "TimingReport.h"
 
 /// A simple interface for a summed area table generator
+/// T is the element type of the input and output data
+template <typename T>
 class SummedAreaTableGenerator
 {
 public:
 	virtual ~SummedAreaTableGenerator() = default; // Virtual destructor needed to destruct inherited classes properly
 
 	// Generate a summed area table of data_in to data_out. 
-	// Returns the elapsed time in milliseconds for just the generation algorithm (no input and output setup)
-	virtual float generate(const DataContainer& data_in, DataContainer& data_out) = 0;
+	// Returns the durations of every phase, from allocating data_out to reading the result back,
+	// so the total covers the whole call and TIMING_PHASE_COMPUTE just the generation algorithm
+	virtual TimingReport generate(const DataContainer<T>& data_in, DataContainer<T>& data_out) = 0;
+
+	// Select how sums larger than the data type maximum are stored. The default is OverflowMode::Saturate
+	void set_overflow_mode(OverflowMode mode) { mOverflowMode = mode; }
+	OverflowMode get_overflow_mode() const { return mOverflowMode; }
+protected:
+	OverflowMode mOverflowMode{OverflowMode::Saturate};
 };
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "SummedAreaTableGeneratorCached.h"
+
+template <typename T>
+SummedAreaTableGeneratorCached<T>::SummedAreaTableGeneratorCached(std::unique_ptr<SummedAreaTableGenerator<T>> generator,
+	const std::string& generator_name, SummedAreaTableCache& cache)
+	: mGenerator(std::move(generator))
+	, mGeneratorName(generator_name)
+	, mCache(cache)
+{
+}
+
+template <typename T>
+TimingReport SummedAreaTableGeneratorCached<T>::generate(const DataContainer<T>& data_in, DataContainer<T>& data_out)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	CacheKey key = SummedAreaTableCache::key(data_in, mGeneratorName, this->mOverflowMode);
+	timer.lap(TIMING_PHASE_CACHE_HASH);
+	mLastWasHit = mCache.load(key, data_in.width, data_in.height, data_out);
+	timer.lap(TIMING_PHASE_CACHE_LOAD);
+	if (!mLastWasHit)
+	{
+		// The wrapped generator reports its own phases
+		mGenerator->set_overflow_mode(this->mOverflowMode);
+		report.add(mGenerator->generate(data_in, data_out));
+		timer.restart();
+		mCache.store(key, data_out);
+		timer.lap(TIMING_PHASE_CACHE_STORE);
+	}
+	return report;
+}
+
+template class SummedAreaTableGeneratorCached<uint8_t>;
+template class SummedAreaTableGeneratorCached<uint16_t>;
+template class SummedAreaTableGeneratorCached<uint32_t>;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "SummedAreaTableCache.h"
+#include "SummedAreaTableGenerator.h"
+
+/// Summed area table generator that looks the result up in a SummedAreaTableCache first
+/// Wraps another generator, which only runs on a cache miss. Its result is then stored in the
+/// cache, so the next run with the same input, generator and overflow mode maps the table in.
+template <typename T>
+class SummedAreaTableGeneratorCached : public SummedAreaTableGenerator<T>
+{
+public:
+	// Cache the results of the generator under the given generator name. The cache needs to outlive this generator
+	SummedAreaTableGeneratorCached(std::unique_ptr<SummedAreaTableGenerator<T>> generator, const std::string& generator_name, SummedAreaTableCache& cache);
+
+	// Reports hashing the input and the cache access, and on a miss the phases of the wrapped generator
+	virtual TimingReport generate(const DataContainer<T>& data_in, DataContainer<T>& data_out) override;
+
+	// Whether the last generate() found the table in the cache
+	bool last_was_hit() const { return mLastWasHit; }
+private:
+	std::unique_ptr<SummedAreaTableGenerator<T>> mGenerator;
+	std::string mGeneratorName;
+	SummedAreaTableCache& mCache;
+	bool mLastWasHit{false};
+};
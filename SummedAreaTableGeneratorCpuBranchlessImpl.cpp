@@ -0,0 +1,78 @@
+#include "SummedAreaTableGeneratorCpuBranchlessImpl.h"
+
+#include <algorithm>
+
+#include "constants.h"
+
+// The smallest accumulator type that can hold the sum of two values of T,
+// so clamping a running sum never needs a wider comparison than necessary
+template <typename T>
+struct BranchlessAccumulator;
+
+template <>
+struct BranchlessAccumulator<uint8_t> { typedef uint16_t type; };
+
+template <>
+struct BranchlessAccumulator<uint16_t> { typedef uint32_t type; };
+
+template <>
+struct BranchlessAccumulator<uint32_t> { typedef uint64_t type; };
+
+template <typename T, OverflowMode Mode>
+static void generate_branchless(const T* input, T* output, int width, int height)
+{
+	typedef typename BranchlessAccumulator<T>::type accumulator_t;
+
+	if (width == 0 || height == 0)
+	{
+		return;
+	}
+
+	// The first row has no row above it
+	accumulator_t row_sum = 0;
+	for (int x = 0; x < width; ++x)
+	{
+		row_sum = reduce_sum<T, Mode>(static_cast<accumulator_t>(row_sum + input[x]));
+		output[x] = static_cast<T>(row_sum);
+	}
+
+	// Every other row is its running row sum added to the output row above. When saturating both are
+	// clamped, which matches the reference because min(min(a, max) + b, max) == min(a + b, max)
+	for (int y = 1; y < height; ++y)
+	{
+		const T* input_row = input + static_cast<size_t>(y) * width;
+		T* output_row = output + static_cast<size_t>(y) * width;
+		const T* previous_output_row = output_row - width;
+
+		row_sum = 0;
+		for (int x = 0; x < width; ++x)
+		{
+			row_sum = reduce_sum<T, Mode>(static_cast<accumulator_t>(row_sum + input_row[x]));
+			output_row[x] = static_cast<T>(reduce_sum<T, Mode>(static_cast<accumulator_t>(row_sum + previous_output_row[x])));
+		}
+	}
+}
+
+template <typename T>
+TimingReport SummedAreaTableGeneratorCpuBranchlessImpl<T>::generate(const DataContainer<T>& data_in, DataContainer<T>& data_out)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	data_out.data.resize(data_in.data.size());
+	data_out.height = data_in.height;
+	data_out.width = data_in.width;
+	timer.lap(TIMING_PHASE_ALLOCATE);
+
+	dispatch_overflow_mode(this->mOverflowMode, [&](auto mode_tag)
+	{
+		generate_branchless<T, decltype(mode_tag)::value>(data_in.data.data(), data_out.data.data(), data_in.width, data_in.height);
+	});
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
+}
+
+template class SummedAreaTableGeneratorCpuBranchlessImpl<uint8_t>;
+template class SummedAreaTableGeneratorCpuBranchlessImpl<uint16_t>;
+template class SummedAreaTableGeneratorCpuBranchlessImpl<uint32_t>;
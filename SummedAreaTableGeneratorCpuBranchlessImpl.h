@@ -0,0 +1,14 @@
+#pragma once
+
+#include "SummedAreaTableGenerator.h"
+
+/// Branch free single pass summed area table generator using the CPU
+/// Keeps a running sum of the current row, so every element only needs the input value
+/// and the output value above it. The first row is handled before the hot loop, and the
+/// kernel is a template specialised for the element type with a just wide enough accumulator.
+template <typename T>
+class SummedAreaTableGeneratorCpuBranchlessImpl : public SummedAreaTableGenerator<T>
+{
+public:
+	virtual TimingReport generate(const DataContainer<T>& data_in, DataContainer<T>& data_out) override;
+};
@@ -1,42 +1,59 @@
 ﻿#include "SummedAreaTableGeneratorCpuImpl.h"
 
 #include <algorithm>
-#include <chrono>
 
 #include "constants.h"
 
 /// Reference for the algorithm: https://en.wikipedia.org/wiki/Summed-area_table
-float SummedAreaTableGeneratorCpuImpl::generate(const DataContainer& data_in, DataContainer& data_out)
+template <typename T>
+TimingReport SummedAreaTableGeneratorCpuImpl<T>::generate(const DataContainer<T>& data_in, DataContainer<T>& data_out)
 {
+	TimingReport report;
+	PhaseTimer timer(report);
+
 	data_out.data.resize(data_in.data.size());
 	data_out.height = data_in.height;
 	data_out.width = data_in.width;
-
-	auto start = std::chrono::high_resolution_clock::now();
+	timer.lap(TIMING_PHASE_ALLOCATE);
 
 	for (int y = 0; y < data_in.height; ++y)
 	{
+		// 64-bit row offsets, as the element count can exceed the int range
+		size_t row = static_cast<size_t>(y) * data_in.width;
+		size_t previous_row = row - data_in.width;
 		for (int x = 0; x < data_in.width; ++x)
 		{
-			uint64_t output_value = data_in.data[y * data_in.width + x];
+			uint64_t output_value = data_in.data[row + x];
 
 			if (x > 0)
 			{
-				output_value += data_out.data[y*data_in.width + (x-1)];
+				output_value += data_out.data[row + (x-1)];
 			}
 			if (y > 0)
 			{
-				output_value += data_out.data[(y-1)*data_in.width + x];
+				output_value += data_out.data[previous_row + x];
 			}
 			if (x > 0 && y > 0)
 			{
-				output_value -= data_out.data[(y - 1)*data_in.width + (x - 1)];
+				output_value -= data_out.data[previous_row + (x - 1)];
 			}
 
-			data_out.data[y * data_in.width + x] = std::min(output_value, DATA_MAX_VALUE);
+			if (this->mOverflowMode == OverflowMode::Wrap)
+			{
+				// Unsigned arithmetic modulo 2^64 is also correct modulo 2^bits, even if the subtraction wraps
+				data_out.data[row + x] = static_cast<T>(output_value);
+			}
+			else
+			{
+				data_out.data[row + x] = std::min(output_value, DATA_MAX_VALUE<T>);
+			}
 		}
 	}
 
-	auto end = std::chrono::high_resolution_clock::now();
-	return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0f;
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
 }
+
+template class SummedAreaTableGeneratorCpuImpl<uint8_t>;
+template class SummedAreaTableGeneratorCpuImpl<uint16_t>;
+template class SummedAreaTableGeneratorCpuImpl<uint32_t>;
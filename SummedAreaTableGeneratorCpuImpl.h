@@ -3,8 +3,9 @@
 #include "SummedAreaTableGenerator.h"
 
 /// Summed area table generator using the CPU
-class SummedAreaTableGeneratorCpuImpl : public SummedAreaTableGenerator
+template <typename T>
+class SummedAreaTableGeneratorCpuImpl : public SummedAreaTableGenerator<T>
 {
 public:
-	virtual float generate(const DataContainer& data_in, DataContainer& data_out) override;
+	virtual TimingReport generate(const DataContainer<T>& data_in, DataContainer<T>& data_out) override;
 };
\ No newline at end of file
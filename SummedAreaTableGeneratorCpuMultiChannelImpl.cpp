@@ -0,0 +1,105 @@
+#include "SummedAreaTableGeneratorCpuMultiChannelImpl.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "constants.h"
+#include "SummedAreaTableSimdKernels.h"
+
+template <typename T>
+SummedAreaTableGeneratorCpuMultiChannelImpl<T>::SummedAreaTableGeneratorCpuMultiChannelImpl(ChannelLayout output_layout)
+	: mOutputLayout(output_layout)
+{
+}
+
+template <typename T>
+template <OverflowMode Mode, int Channels>
+void SummedAreaTableGeneratorCpuMultiChannelImpl<T>::generate_channels(const DataContainer<T>& data_in, DataContainer<T>& data_out)
+{
+	int width = data_in.width;
+	int height = data_in.height;
+	size_t row_size = static_cast<size_t>(width) * Channels;
+	const T* input = data_in.data.data();
+	T* output = data_out.data.data();
+
+	if (mOutputLayout == ChannelLayout::Interleaved || Channels == 1)
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			T* output_row = output + y * row_size;
+			const T* previous_output_row = y > 0 ? output_row - row_size : nullptr;
+			summed_area_table_row_channels<T, Mode, Channels>(input + y * row_size, previous_output_row, output_row, width);
+		}
+		return;
+	}
+
+	// Generate interleaved rows into the buffer, alternating between its halves, and scatter them to the planes
+	mRowBuffer.resize(2 * row_size);
+	size_t plane_size = static_cast<size_t>(width) * height;
+	for (int y = 0; y < height; ++y)
+	{
+		T* output_row = mRowBuffer.data() + (y % 2) * row_size;
+		const T* previous_output_row = y > 0 ? mRowBuffer.data() + ((y + 1) % 2) * row_size : nullptr;
+		summed_area_table_row_channels<T, Mode, Channels>(input + y * row_size, previous_output_row, output_row, width);
+
+		for (int channel = 0; channel < Channels; ++channel)
+		{
+			T* plane_row = output + channel * plane_size + static_cast<size_t>(y) * width;
+			for (int x = 0; x < width; ++x)
+			{
+				plane_row[x] = output_row[x * Channels + channel];
+			}
+		}
+	}
+}
+
+template <typename T>
+TimingReport SummedAreaTableGeneratorCpuMultiChannelImpl<T>::generate(const DataContainer<T>& data_in, DataContainer<T>& data_out)
+{
+	int channels = data_in.channels;
+	if (channels < 1 || channels > MAX_CHANNELS)
+	{
+		throw std::runtime_error("Unsupported channel count " + std::to_string(channels) + ", expected 1 to " + std::to_string(MAX_CHANNELS));
+	}
+	if (channels > 1 && data_in.channel_layout != ChannelLayout::Interleaved)
+	{
+		throw std::runtime_error("The multi-channel generator expects interleaved input");
+	}
+
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	data_out.data.resize(data_in.data.size());
+	data_out.height = data_in.height;
+	data_out.width = data_in.width;
+	data_out.channels = channels;
+	data_out.channel_layout = mOutputLayout;
+	timer.lap(TIMING_PHASE_ALLOCATE);
+
+	dispatch_overflow_mode(this->mOverflowMode, [&](auto mode_tag)
+	{
+		constexpr OverflowMode Mode = decltype(mode_tag)::value;
+		switch (channels)
+		{
+			case 1:
+				generate_channels<Mode, 1>(data_in, data_out);
+				break;
+			case 2:
+				generate_channels<Mode, 2>(data_in, data_out);
+				break;
+			case 3:
+				generate_channels<Mode, 3>(data_in, data_out);
+				break;
+			default:
+				generate_channels<Mode, 4>(data_in, data_out);
+				break;
+		}
+	});
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
+}
+
+template class SummedAreaTableGeneratorCpuMultiChannelImpl<uint8_t>;
+template class SummedAreaTableGeneratorCpuMultiChannelImpl<uint16_t>;
+template class SummedAreaTableGeneratorCpuMultiChannelImpl<uint32_t>;
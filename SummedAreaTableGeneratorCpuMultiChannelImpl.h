@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "SummedAreaTableGenerator.h"
+
+/// Summed area table generator for images with up to 4 interleaved channels, like RGB or RGBA
+/// The tables of every channel are computed in one pass over the interleaved input instead of
+/// de-interleaving it and generating every channel on its own. The channels map to the SIMD lanes,
+/// so a row of every channel is summed in the same instructions like the SIMD generator sums one row.
+/// The output is interleaved like the input, or planar, where every channel table can be queried on its own.
+template <typename T>
+class SummedAreaTableGeneratorCpuMultiChannelImpl : public SummedAreaTableGenerator<T>
+{
+public:
+	explicit SummedAreaTableGeneratorCpuMultiChannelImpl(ChannelLayout output_layout = ChannelLayout::Interleaved);
+
+	// Generate the table of every channel of data_in, whose channel layout needs to be interleaved
+	// unless it has only one channel. data_out gets the same channel count and the output layout
+	// Will throw a std::runtime_error if the input has more than MAX_CHANNELS channels or is planar
+	virtual TimingReport generate(const DataContainer<T>& data_in, DataContainer<T>& data_out) override;
+
+	void set_output_layout(ChannelLayout layout) { mOutputLayout = layout; }
+	ChannelLayout get_output_layout() const { return mOutputLayout; }
+
+	static const int MAX_CHANNELS = 4;
+private:
+	template <OverflowMode Mode, int Channels>
+	void generate_channels(const DataContainer<T>& data_in, DataContainer<T>& data_out);
+
+	ChannelLayout mOutputLayout;
+	// The previous and current output rows, interleaved, while generating planar output
+	std::vector<T> mRowBuffer;
+};
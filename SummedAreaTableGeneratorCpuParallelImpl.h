@@ -0,0 +1,19 @@
+#pragma once
+
+#include "SummedAreaTableGenerator.h"
+
+/// Multithreaded summed area table generator using the CPU
+/// Uses the same separable algorithm as the GPU implementation: first every row
+/// is summed horizontally, rows split between the threads, and then every column
+/// is summed vertically, columns split into strips between the threads.
+template <typename T>
+class SummedAreaTableGeneratorCpuParallelImpl : public SummedAreaTableGenerator<T>
+{
+public:
+	// Create the generator using the given number of threads. 0 uses every hardware thread
+	explicit SummedAreaTableGeneratorCpuParallelImpl(int thread_count = 0);
+
+	virtual TimingReport generate(const DataContainer<T>& data_in, DataContainer<T>& data_out) override;
+private:
+	int mThreadCount;
+};
@@ -0,0 +1,43 @@
+#include "SummedAreaTableGeneratorCpuSimdImpl.h"
+
+#include <algorithm>
+
+#include "constants.h"
+#include "SummedAreaTableSimdKernels.h"
+
+template <typename T, OverflowMode Mode>
+static void generate_rows(const T* input, T* output, int width, int height)
+{
+	for (int y = 0; y < height; ++y)
+	{
+		const T* input_row = input + static_cast<size_t>(y) * width;
+		T* output_row = output + static_cast<size_t>(y) * width;
+		const T* previous_output_row = y > 0 ? output_row - width : nullptr;
+
+		summed_area_table_row<T, Mode>(input_row, previous_output_row, output_row, width);
+	}
+}
+
+template <typename T>
+TimingReport SummedAreaTableGeneratorCpuSimdImpl<T>::generate(const DataContainer<T>& data_in, DataContainer<T>& data_out)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	data_out.data.resize(data_in.data.size());
+	data_out.height = data_in.height;
+	data_out.width = data_in.width;
+	timer.lap(TIMING_PHASE_ALLOCATE);
+
+	dispatch_overflow_mode(this->mOverflowMode, [&](auto mode_tag)
+	{
+		generate_rows<T, decltype(mode_tag)::value>(data_in.data.data(), data_out.data.data(), data_in.width, data_in.height);
+	});
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
+}
+
+template class SummedAreaTableGeneratorCpuSimdImpl<uint8_t>;
+template class SummedAreaTableGeneratorCpuSimdImpl<uint16_t>;
+template class SummedAreaTableGeneratorCpuSimdImpl<uint32_t>;
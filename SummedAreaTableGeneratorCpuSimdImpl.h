@@ -0,0 +1,14 @@
+#pragma once
+
+#include "SummedAreaTableGenerator.h"
+
+/// Summed area table generator using SIMD instructions on the CPU
+/// Every row is prefix summed inside vector registers and added to the previous
+/// output row a full vector at a time, saturating like the reference implementation.
+/// Falls back to a scalar loop when the build doesn't target SSE2 or AVX2.
+template <typename T>
+class SummedAreaTableGeneratorCpuSimdImpl : public SummedAreaTableGenerator<T>
+{
+public:
+	virtual TimingReport generate(const DataContainer<T>& data_in, DataContainer<T>& data_out) override;
+};
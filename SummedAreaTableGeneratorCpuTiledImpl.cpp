@@ -0,0 +1,180 @@
+#include "SummedAreaTableGeneratorCpuTiledImpl.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "constants.h"
+
+template <typename T>
+SummedAreaTableGeneratorCpuTiledImpl<T>::SummedAreaTableGeneratorCpuTiledImpl(int tile_width, int tile_height)
+	: mTileWidth(tile_width), mTileHeight(tile_height)
+{
+	if (tile_width <= 0 || tile_height <= 0)
+	{
+		throw std::runtime_error("Invalid tile size " + std::to_string(tile_width) + " x " + std::to_string(tile_height));
+	}
+}
+
+template <typename T>
+TimingReport SummedAreaTableGeneratorCpuTiledImpl<T>::generate(const DataContainer<T>& data_in, DataContainer<T>& data_out)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	data_out.data.resize(data_in.data.size());
+	data_out.height = data_in.height;
+	data_out.width = data_in.width;
+	timer.lap(TIMING_PHASE_ALLOCATE);
+
+	dispatch_overflow_mode(this->mOverflowMode, [&](auto mode_tag)
+	{
+		generate_tiles<decltype(mode_tag)::value>(data_in, data_out);
+	});
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
+}
+
+template <typename T>
+template <OverflowMode Mode>
+void SummedAreaTableGeneratorCpuTiledImpl<T>::generate_tiles(const DataContainer<T>& data_in, DataContainer<T>& data_out)
+{
+	mWidth = data_in.width;
+	mHeight = data_in.height;
+	int tile_count_x = (mWidth + mTileWidth - 1) / mTileWidth;
+	int tile_count_y = (mHeight + mTileHeight - 1) / mTileHeight;
+	mRightColumnCarries.resize(static_cast<size_t>(tile_count_x) * mHeight);
+	mBottomRowCarries.resize(static_cast<size_t>(tile_count_y) * mWidth);
+
+	auto tile_at = [&](int tile_x, int tile_y)
+	{
+		Tile tile;
+		tile.x_begin = tile_x * mTileWidth;
+		tile.y_begin = tile_y * mTileHeight;
+		tile.x_end = std::min(tile.x_begin + mTileWidth, mWidth);
+		tile.y_end = std::min(tile.y_begin + mTileHeight, mHeight);
+		return tile;
+	};
+
+	for (int tile_y = 0; tile_y < tile_count_y; ++tile_y)
+	{
+		for (int tile_x = 0; tile_x < tile_count_x; ++tile_x)
+		{
+			compute_local_table<Mode>(data_in, data_out, tile_at(tile_x, tile_y));
+		}
+	}
+
+	// The border pass only touches the right column and bottom row of every tile, so it is cheap.
+	// Tiles are visited in row-major order because each border depends on the borders to the left and above
+	for (int tile_y = 0; tile_y < tile_count_y; ++tile_y)
+	{
+		for (int tile_x = 0; tile_x < tile_count_x; ++tile_x)
+		{
+			compute_border_carries<Mode>(data_out, tile_at(tile_x, tile_y), tile_x, tile_y);
+		}
+	}
+
+	for (int tile_y = 0; tile_y < tile_count_y; ++tile_y)
+	{
+		for (int tile_x = 0; tile_x < tile_count_x; ++tile_x)
+		{
+			apply_carries<Mode>(data_out, tile_at(tile_x, tile_y), tile_x, tile_y);
+		}
+	}
+}
+
+template <typename T>
+template <OverflowMode Mode>
+void SummedAreaTableGeneratorCpuTiledImpl<T>::compute_local_table(const DataContainer<T>& data_in, DataContainer<T>& data_out, const Tile& tile)
+{
+	for (int y = tile.y_begin; y < tile.y_end; ++y)
+	{
+		const T* input_row = data_in.data.data() + static_cast<size_t>(y) * mWidth;
+		T* output_row = data_out.data.data() + static_cast<size_t>(y) * mWidth;
+		uint64_t current_sum = 0;
+
+		for (int x = tile.x_begin; x < tile.x_end; ++x)
+		{
+			current_sum = reduce_sum<T, Mode>(current_sum + input_row[x]);
+			uint64_t output_value = current_sum;
+			if (y > tile.y_begin)
+			{
+				output_value = reduce_sum<T, Mode>(output_value + output_row[x - mWidth]);
+			}
+			output_row[x] = static_cast<T>(output_value);
+		}
+	}
+}
+
+// Combining clamped values gives the same result as the reference: if any of the carries
+// is clamped, the final value is at least the maximum anyway, because the left and top
+// carries are never smaller than the corner carry. Wrapped values combine exactly modulo 2^bits
+template <typename T>
+template <OverflowMode Mode>
+void SummedAreaTableGeneratorCpuTiledImpl<T>::compute_border_carries(const DataContainer<T>& data_out, const Tile& tile, int tile_x, int tile_y)
+{
+	const T* left_carries = tile_x > 0 ? &mRightColumnCarries[static_cast<size_t>(tile_x - 1) * mHeight] : nullptr;
+	const T* top_carries = tile_y > 0 ? &mBottomRowCarries[static_cast<size_t>(tile_y - 1) * mWidth] : nullptr;
+	uint64_t corner_carry = left_carries != nullptr && top_carries != nullptr ? top_carries[tile.x_begin - 1] : 0;
+
+	auto final_value = [&](int x, int y)
+	{
+		uint64_t value = data_out.data[static_cast<size_t>(y) * mWidth + x];
+		if (left_carries != nullptr)
+		{
+			value += left_carries[y];
+		}
+		if (top_carries != nullptr)
+		{
+			value += top_carries[x];
+		}
+		return static_cast<T>(reduce_sum<T, Mode>(value - corner_carry));
+	};
+
+	T* right_column = &mRightColumnCarries[static_cast<size_t>(tile_x) * mHeight];
+	for (int y = tile.y_begin; y < tile.y_end; ++y)
+	{
+		right_column[y] = final_value(tile.x_end - 1, y);
+	}
+
+	T* bottom_row = &mBottomRowCarries[static_cast<size_t>(tile_y) * mWidth];
+	for (int x = tile.x_begin; x < tile.x_end; ++x)
+	{
+		bottom_row[x] = final_value(x, tile.y_end - 1);
+	}
+}
+
+template <typename T>
+template <OverflowMode Mode>
+void SummedAreaTableGeneratorCpuTiledImpl<T>::apply_carries(DataContainer<T>& data_out, const Tile& tile, int tile_x, int tile_y)
+{
+	if (tile_x == 0 && tile_y == 0)
+	{
+		return; // The local table of the first tile is already final
+	}
+
+	const T* left_carries = tile_x > 0 ? &mRightColumnCarries[static_cast<size_t>(tile_x - 1) * mHeight] : nullptr;
+	const T* top_carries = tile_y > 0 ? &mBottomRowCarries[static_cast<size_t>(tile_y - 1) * mWidth] : nullptr;
+	uint64_t corner_carry = left_carries != nullptr && top_carries != nullptr ? top_carries[tile.x_begin - 1] : 0;
+
+	for (int y = tile.y_begin; y < tile.y_end; ++y)
+	{
+		T* output_row = data_out.data.data() + static_cast<size_t>(y) * mWidth;
+		uint64_t left_carry = (left_carries != nullptr ? left_carries[y] : 0) - corner_carry;
+
+		for (int x = tile.x_begin; x < tile.x_end; ++x)
+		{
+			uint64_t value = output_row[x] + left_carry;
+			if (top_carries != nullptr)
+			{
+				value += top_carries[x];
+			}
+			output_row[x] = static_cast<T>(reduce_sum<T, Mode>(value));
+		}
+	}
+}
+
+template class SummedAreaTableGeneratorCpuTiledImpl<uint8_t>;
+template class SummedAreaTableGeneratorCpuTiledImpl<uint16_t>;
+template class SummedAreaTableGeneratorCpuTiledImpl<uint32_t>;
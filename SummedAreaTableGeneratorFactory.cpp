@@ -0,0 +1,87 @@
+#include "SummedAreaTableGeneratorFactory.h"
+
+#include <stdexcept>
+
+#include "SummedAreaTableGeneratorCpuImpl.h"
+#include "SummedAreaTableGeneratorCpuParallelImpl.h"
+#include "SummedAreaTableGeneratorCpuSimdImpl.h"
+#include "SummedAreaTableGeneratorCpuTiledImpl.h"
+#include "SummedAreaTableGeneratorCpuBranchlessImpl.h"
+
+struct CpuGeneratorName
+{
+	const char* name;
+	const char* display_name;
+};
+
+static const CpuGeneratorName CPU_GENERATOR_NAMES[] = {
+	{ "reference", "CPU" },
+	{ "parallel", "CPU Parallel" },
+	{ "simd", "CPU SIMD" },
+	{ "tiled", "CPU Tiled" },
+	{ "branchless", "CPU Branchless" },
+};
+
+const std::vector<std::string>& SummedAreaTableGeneratorFactory::cpu_generator_names()
+{
+	static const std::vector<std::string> names = []
+	{
+		std::vector<std::string> generator_names;
+		for (const CpuGeneratorName& generator_name : CPU_GENERATOR_NAMES)
+		{
+			generator_names.push_back(generator_name.name);
+		}
+		return generator_names;
+	}();
+	return names;
+}
+
+std::string SummedAreaTableGeneratorFactory::display_name(const std::string& name)
+{
+	for (const CpuGeneratorName& generator_name : CPU_GENERATOR_NAMES)
+	{
+		if (name == generator_name.name)
+		{
+			return generator_name.display_name;
+		}
+	}
+	return name;
+}
+
+template <typename T>
+static std::unique_ptr<SummedAreaTableGenerator<T>> create_cpu_generator_by_name(const std::string& name, const CpuGeneratorSettings& settings)
+{
+	if (name == "reference")
+	{
+		return std::make_unique<SummedAreaTableGeneratorCpuImpl<T>>();
+	}
+	if (name == "parallel")
+	{
+		return std::make_unique<SummedAreaTableGeneratorCpuParallelImpl<T>>(settings.thread_count);
+	}
+	if (name == "simd")
+	{
+		return std::make_unique<SummedAreaTableGeneratorCpuSimdImpl<T>>();
+	}
+	if (name == "tiled")
+	{
+		return std::make_unique<SummedAreaTableGeneratorCpuTiledImpl<T>>(settings.tile_size, settings.tile_size);
+	}
+	if (name == "branchless")
+	{
+		return std::make_unique<SummedAreaTableGeneratorCpuBranchlessImpl<T>>();
+	}
+	throw std::runtime_error("Unknown CPU generator " + name);
+}
+
+template <typename T>
+std::unique_ptr<SummedAreaTableGenerator<T>> SummedAreaTableGeneratorFactory::create_cpu_generator(const std::string& name, const CpuGeneratorSettings& settings)
+{
+	std::unique_ptr<SummedAreaTableGenerator<T>> generator = create_cpu_generator_by_name<T>(name, settings);
+	generator->set_overflow_mode(settings.overflow_mode);
+	return generator;
+}
+
+template std::unique_ptr<SummedAreaTableGenerator<uint8_t>> SummedAreaTableGeneratorFactory::create_cpu_generator<uint8_t>(const std::string&, const CpuGeneratorSettings&);
+template std::unique_ptr<SummedAreaTableGenerator<uint16_t>> SummedAreaTableGeneratorFactory::create_cpu_generator<uint16_t>(const std::string&, const CpuGeneratorSettings&);
+template std::unique_ptr<SummedAreaTableGenerator<uint32_t>> SummedAreaTableGeneratorFactory::create_cpu_generator<uint32_t>(const std::string&, const CpuGeneratorSettings&);
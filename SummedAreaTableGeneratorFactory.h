@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SummedAreaTableGenerator.h"
+
+// Settings shared by the configurable CPU generators
+struct CpuGeneratorSettings
+{
+	// Number of threads for the multithreaded generators, 0 uses every hardware thread
+	int thread_count{0};
+	// Tile size in elements for the tiled generator
+	int tile_size{256};
+	// How sums larger than the data type maximum are stored
+	OverflowMode overflow_mode{OverflowMode::Saturate};
+};
+
+// Creates the CPU summed area table generators by name, so they can be selected
+// from the command line and iterated in the benchmark
+class SummedAreaTableGeneratorFactory
+{
+public:
+	// Names of every CPU generator. The first one is the reference implementation
+	static const std::vector<std::string>& cpu_generator_names();
+
+	// Human readable name of the generator for printing, like "CPU Parallel"
+	static std::string display_name(const std::string& name);
+
+	// Create the CPU generator with the given name for the element type T
+	// Will throw a std::runtime_error if there is no generator with the name
+	template <typename T>
+	static std::unique_ptr<SummedAreaTableGenerator<T>> create_cpu_generator(const std::string& name, const CpuGeneratorSettings& settings);
+};
@@ -1,6 +1,5 @@
 #include "SummedAreaTableGeneratorGpuImpl.h"
 
-#include <chrono>
 #include <iostream>
 #include <thread>
 
@@ -11,11 +10,12 @@
 
 static const float THREAD_GROUP_SIZE = 64.0f; // Numthreads in the compute shaders needs to be changed also
 
-SummedAreaTableGeneratorGpuImpl::SummedAreaTableGeneratorGpuImpl()
+template <typename T>
+SummedAreaTableGeneratorGpuImpl<T>::SummedAreaTableGeneratorGpuImpl()
 {
     setup_shaders();
   
-    switch (DATA_NUM_OF_BITS)
+    switch (DATA_NUM_OF_BITS<T>)
     {
         case 8:
             mDataFormat = DXGI_FORMAT_R8_UINT;
@@ -27,25 +27,35 @@ SummedAreaTableGeneratorGpuImpl::SummedAreaTableGeneratorGpuImpl()
             mDataFormat = DXGI_FORMAT_R32_UINT;
             break;
         default:
-            throw std::runtime_error("Unsupported data type size of "+std::to_string(DATA_NUM_OF_BITS)+" bits!");
+            throw std::runtime_error("Unsupported data type size of "+std::to_string(DATA_NUM_OF_BITS<T>)+" bits!");
     }
 }
 
-float SummedAreaTableGeneratorGpuImpl::generate(const DataContainer& data_in, DataContainer& data_out)
+template <typename T>
+TimingReport SummedAreaTableGeneratorGpuImpl<T>::generate(const DataContainer<T>& data_in, DataContainer<T>& data_out)
 {
-    create_input_texture(data_in);
+    if (data_in.width > MAX_TEXTURE_DIMENSION || data_in.height > MAX_TEXTURE_DIMENSION)
+    {
+        throw std::runtime_error("The GPU textures can't be larger than " + std::to_string(MAX_TEXTURE_DIMENSION) + " x " + std::to_string(MAX_TEXTURE_DIMENSION));
+    }
+
+    TimingReport report;
+    PhaseTimer timer(report);
+
+    create_input_texture(data_in, timer);
     create_output_texture(data_in);
+    timer.lap(TIMING_PHASE_SETUP);
 
-    auto start = std::chrono::high_resolution_clock::now();
     compute_summed_area_table(data_in);
-    auto end = std::chrono::high_resolution_clock::now();
+    timer.lap(TIMING_PHASE_COMPUTE);
 
     readback_output_data(data_in, data_out);
-
-    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0f;
+    timer.lap(TIMING_PHASE_READBACK);
+    return report;
 }
 
-void SummedAreaTableGeneratorGpuImpl::create_input_texture(const DataContainer& input_data)
+template <typename T>
+void SummedAreaTableGeneratorGpuImpl<T>::create_input_texture(const DataContainer<T>& input_data, PhaseTimer& timer)
 {
     // Create the compute shader input texture
     D3D12_RESOURCE_DESC texture_description{};
@@ -68,25 +78,27 @@ void SummedAreaTableGeneratorGpuImpl::create_input_texture(const DataContainer&
     mPlacedBufferFootprint.Footprint.Height = input_data.height;
     mPlacedBufferFootprint.Footprint.Depth = 1;
     // Texture rows need to be aligned with 256 bytes(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT)
-    mPlacedBufferFootprint.Footprint.RowPitch = std::ceil(sizeof(data_t) * (float)input_data.width / D3D12_TEXTURE_DATA_PITCH_ALIGNMENT) * D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
+    mPlacedBufferFootprint.Footprint.RowPitch = std::ceil(sizeof(T) * (float)input_data.width / D3D12_TEXTURE_DATA_PITCH_ALIGNMENT) * D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
 
     // Create a flat buffer on the upload heap to upload the data into the GPU
-    D3D12_RESOURCE_DESC buffer_description = CD3DX12_RESOURCE_DESC::Buffer(mPlacedBufferFootprint.Footprint.Height * mPlacedBufferFootprint.Footprint.RowPitch);
+    D3D12_RESOURCE_DESC buffer_description = CD3DX12_RESOURCE_DESC::Buffer(static_cast<UINT64>(mPlacedBufferFootprint.Footprint.Height) * mPlacedBufferFootprint.Footprint.RowPitch);
     ComPtr<ID3D12Resource> upload_buffer;
     D3D12_HEAP_PROPERTIES upload_heap = D3D12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
     DirectXHelper::check_result(DirectXHelper::instance()->get_device()->CreateCommittedResource(&upload_heap, D3D12_HEAP_FLAG_NONE,
         &buffer_description, D3D12_RESOURCE_STATE_COPY_SOURCE, nullptr, IID_PPV_ARGS(&upload_buffer)));
 
+    timer.lap(TIMING_PHASE_SETUP);
+
     // Map the buffer for CPU access
     D3D12_RANGE read_range(0, 0); // We will only write the input data
-    data_t* upload_buffer_start;
+    T* upload_buffer_start;
     DirectXHelper::check_result(upload_buffer->Map(0, &read_range, reinterpret_cast<void**>(&upload_buffer_start)));
 
     // Copy the input data into the upload buffer
     for (int y = 0; y < input_data.height; ++y)
     {
-        data_t* row_start = upload_buffer_start + y*mPlacedBufferFootprint.Footprint.RowPitch/sizeof(data_t);
-        memcpy(row_start, &(input_data.data[y * input_data.width]), sizeof(data_t)*input_data.width);
+        T* row_start = upload_buffer_start + static_cast<size_t>(y) * mPlacedBufferFootprint.Footprint.RowPitch/sizeof(T);
+        memcpy(row_start, &(input_data.data[static_cast<size_t>(y) * input_data.width]), sizeof(T)*input_data.width);
     }
 
     // Copy the data from the upload buffer into the texture
@@ -98,6 +110,7 @@ void SummedAreaTableGeneratorGpuImpl::create_input_texture(const DataContainer&
 
     // Execute the copy command and wait for it to finish, so that it doesn't affect benchmarking the algorithm
     DirectXHelper::instance()->execute_command_list_and_wait(command_list);
+    timer.lap(TIMING_PHASE_UPLOAD);
 
     // Create an UAV (unordered access view) to use the input texture in shaders
     D3D12_UNORDERED_ACCESS_VIEW_DESC unordered_access_view_desc{};
@@ -107,7 +120,8 @@ void SummedAreaTableGeneratorGpuImpl::create_input_texture(const DataContainer&
     DirectXHelper::instance()->get_device()->CreateUnorderedAccessView(mInputTexture.Get(), nullptr, &unordered_access_view_desc, cpu_descriptor_handle);
 }
 
-void SummedAreaTableGeneratorGpuImpl::create_output_texture(const DataContainer& input_data)
+template <typename T>
+void SummedAreaTableGeneratorGpuImpl<T>::create_output_texture(const DataContainer<T>& input_data)
 {
     // Create the compute shader output texture 
     D3D12_RESOURCE_DESC texture_description{};
@@ -125,7 +139,7 @@ void SummedAreaTableGeneratorGpuImpl::create_output_texture(const DataContainer&
         &texture_description, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&mOutputTexture)));
 
     // Create a readback buffer to read the output data back to the CPU
-    D3D12_RESOURCE_DESC buffer_description = CD3DX12_RESOURCE_DESC::Buffer(mPlacedBufferFootprint.Footprint.Height * mPlacedBufferFootprint.Footprint.RowPitch);
+    D3D12_RESOURCE_DESC buffer_description = CD3DX12_RESOURCE_DESC::Buffer(static_cast<UINT64>(mPlacedBufferFootprint.Footprint.Height) * mPlacedBufferFootprint.Footprint.RowPitch);
     D3D12_HEAP_PROPERTIES readback_heap = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK);
     DirectXHelper::check_result(DirectXHelper::instance()->get_device()->CreateCommittedResource(&readback_heap, D3D12_HEAP_FLAG_NONE,
         &buffer_description, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&mReadbackBuffer)));
@@ -138,7 +152,8 @@ void SummedAreaTableGeneratorGpuImpl::create_output_texture(const DataContainer&
     DirectXHelper::instance()->get_device()->CreateUnorderedAccessView(mOutputTexture.Get(), nullptr, &unordered_access_view_desc, cpu_descriptor_handle);
 }
 
-void SummedAreaTableGeneratorGpuImpl::compute_summed_area_table(const DataContainer& input_data)
+template <typename T>
+void SummedAreaTableGeneratorGpuImpl<T>::compute_summed_area_table(const DataContainer<T>& input_data)
 {
     ID3D12DescriptorHeap* descriptor_heaps[] = { mDescriptorHeap.Get() };
 
@@ -147,7 +162,8 @@ void SummedAreaTableGeneratorGpuImpl::compute_summed_area_table(const DataContai
     horizontal_command_list->SetDescriptorHeaps(1, descriptor_heaps);
     horizontal_command_list->SetComputeRootSignature(mHorizontalSweepShaderProgram.root_signature.Get());
     horizontal_command_list->SetComputeRootDescriptorTable(0, CD3DX12_GPU_DESCRIPTOR_HANDLE(mDescriptorHeap->GetGPUDescriptorHandleForHeapStart(), 0, mDescriptorSize));
-    horizontal_command_list->SetComputeRoot32BitConstant(1, DATA_MAX_VALUE, 0);
+    horizontal_command_list->SetComputeRoot32BitConstant(1, DATA_MAX_VALUE<T>, 0);
+    horizontal_command_list->SetComputeRoot32BitConstant(1, this->mOverflowMode == OverflowMode::Wrap, 1);
     horizontal_command_list->SetPipelineState(mHorizontalSweepShaderProgram.pipeline_state.Get());
     horizontal_command_list->Dispatch(1, std::ceil(input_data.height / THREAD_GROUP_SIZE), 1);
 
@@ -169,7 +185,8 @@ void SummedAreaTableGeneratorGpuImpl::compute_summed_area_table(const DataContai
     vertical_command_list->SetDescriptorHeaps(1, descriptor_heaps);
     vertical_command_list->SetComputeRootSignature(mVerticalSweepShaderProgram.root_signature.Get());
     vertical_command_list->SetComputeRootDescriptorTable(0, CD3DX12_GPU_DESCRIPTOR_HANDLE(mDescriptorHeap->GetGPUDescriptorHandleForHeapStart(), 0, mDescriptorSize));
-    vertical_command_list->SetComputeRoot32BitConstant(1, DATA_MAX_VALUE, 0);
+    vertical_command_list->SetComputeRoot32BitConstant(1, DATA_MAX_VALUE<T>, 0);
+    vertical_command_list->SetComputeRoot32BitConstant(1, this->mOverflowMode == OverflowMode::Wrap, 1);
     vertical_command_list->SetPipelineState(mVerticalSweepShaderProgram.pipeline_state.Get());
     vertical_command_list->Dispatch(std::ceil(input_data.width / THREAD_GROUP_SIZE), 1, 1);
     DirectXHelper::check_result(vertical_command_list->Close());
@@ -177,7 +194,8 @@ void SummedAreaTableGeneratorGpuImpl::compute_summed_area_table(const DataContai
     DirectXHelper::instance()->execute_command_list_and_wait(vertical_command_list);
 }
 
-void SummedAreaTableGeneratorGpuImpl::readback_output_data(const DataContainer& input_data, DataContainer& output_data)
+template <typename T>
+void SummedAreaTableGeneratorGpuImpl<T>::readback_output_data(const DataContainer<T>& input_data, DataContainer<T>& output_data)
 {
     ComPtr<ID3D12GraphicsCommandList> command_list = DirectXHelper::instance()->create_direct_command_list();
 
@@ -200,7 +218,7 @@ void SummedAreaTableGeneratorGpuImpl::readback_output_data(const DataContainer&
     DirectXHelper::instance()->execute_command_list_and_wait(command_list);
 
     // Map the readback buffer for CPU access
-    data_t* readback_data_start;
+    T* readback_data_start;
     DirectXHelper::check_result(mReadbackBuffer->Map(0, nullptr, reinterpret_cast<void**>(&readback_data_start)));
 
     // Prepare the output data container
@@ -211,12 +229,13 @@ void SummedAreaTableGeneratorGpuImpl::readback_output_data(const DataContainer&
     // Copy the data from the readback buffer into the output data container 
     for (int y = 0; y < input_data.height; ++y)
     {
-        data_t* row_start = readback_data_start + y * mPlacedBufferFootprint.Footprint.RowPitch / sizeof(data_t);
-        memcpy(&(output_data.data[y*input_data.width]), row_start, sizeof(data_t) * input_data.width);
+        T* row_start = readback_data_start + static_cast<size_t>(y) * mPlacedBufferFootprint.Footprint.RowPitch / sizeof(T);
+        memcpy(&(output_data.data[static_cast<size_t>(y) * input_data.width]), row_start, sizeof(T) * input_data.width);
     }
 }
 
-void SummedAreaTableGeneratorGpuImpl::setup_shaders()
+template <typename T>
+void SummedAreaTableGeneratorGpuImpl<T>::setup_shaders()
 {
     // We can reuse the same root signature for both shaders
     ComPtr<ID3D12RootSignature> root_signature = create_root_signature();
@@ -240,7 +259,8 @@ void SummedAreaTableGeneratorGpuImpl::setup_shaders()
     mDescriptorSize = DirectXHelper::instance()->get_device()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 }
 
-void SummedAreaTableGeneratorGpuImpl::setup_pipeline_state(ShaderProgram& shader_program)
+template <typename T>
+void SummedAreaTableGeneratorGpuImpl<T>::setup_pipeline_state(ShaderProgram& shader_program)
 {
     D3D12_COMPUTE_PIPELINE_STATE_DESC pipeline_state_desc{};
     pipeline_state_desc.pRootSignature = shader_program.root_signature.Get();
@@ -249,7 +269,8 @@ void SummedAreaTableGeneratorGpuImpl::setup_pipeline_state(ShaderProgram& shader
     DirectXHelper::check_result(DirectXHelper::instance()->get_device()->CreateComputePipelineState(&pipeline_state_desc, IID_PPV_ARGS(&(shader_program.pipeline_state))));
 }
 
-ComPtr<ID3D12RootSignature> SummedAreaTableGeneratorGpuImpl::create_root_signature()
+template <typename T>
+ComPtr<ID3D12RootSignature> SummedAreaTableGeneratorGpuImpl<T>::create_root_signature()
 {
     // Create root signature description
     const CD3DX12_STATIC_SAMPLER_DESC sampler(0, D3D12_FILTER_MIN_MAG_MIP_LINEAR);
@@ -260,7 +281,7 @@ ComPtr<ID3D12RootSignature> SummedAreaTableGeneratorGpuImpl::create_root_signatu
 
     CD3DX12_ROOT_PARAMETER1 root_parameters[2];
     root_parameters[0].InitAsDescriptorTable(1, &descriptor_range[0]);
-    root_parameters[1].InitAsConstants(1, 1);
+    root_parameters[1].InitAsConstants(2, 1); // max_value and wrap
     root_signature_desc.Init_1_1(_countof(root_parameters), root_parameters, 1, &sampler, D3D12_ROOT_SIGNATURE_FLAG_NONE);
 
     // Serialize the root signature
@@ -282,3 +303,6 @@ ComPtr<ID3D12RootSignature> SummedAreaTableGeneratorGpuImpl::create_root_signatu
     return root_signature;
 }
 
+template class SummedAreaTableGeneratorGpuImpl<uint8_t>;
+template class SummedAreaTableGeneratorGpuImpl<uint16_t>;
+template class SummedAreaTableGeneratorGpuImpl<uint32_t>;
@@ -14,7 +14,8 @@ using namespace Microsoft::WRL;
 // is needed compared to using the CPU. The problem is separable
 // (We can calculate horizontal and vertical sums separately),
 // so we will do that with compute shaders.
-class SummedAreaTableGeneratorGpuImpl : public SummedAreaTableGenerator
+template <typename T>
+class SummedAreaTableGeneratorGpuImpl : public SummedAreaTableGenerator<T>
 {
 public:
 	// Create the summed area table generator, initializing the used compute shaders
@@ -24,7 +25,11 @@ public:
 	// Not copyable or movable
 	SummedAreaTableGeneratorGpuImpl(const SummedAreaTableGeneratorGpuImpl&) = delete;
 
-	virtual float generate(const DataContainer& data_in, DataContainer& data_out) override;
+	// Will throw std::runtime_error if the input is wider or taller than MAX_TEXTURE_DIMENSION
+	virtual TimingReport generate(const DataContainer<T>& data_in, DataContainer<T>& data_out) override;
+
+	// Largest width and height of the input, limited by the size of a 2D texture
+	static const int MAX_TEXTURE_DIMENSION = D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION;
 private:
 	struct ShaderProgram
 	{
@@ -38,10 +43,11 @@ private:
 		int data_max_size;
 	};
 
-	void create_input_texture(const DataContainer& input_data);
-	void create_output_texture(const DataContainer& input_data);
-	void compute_summed_area_table(const DataContainer& input_data);
-	void readback_output_data(const DataContainer& input_data, DataContainer& output_data);
+	// Reports creating the texture and the upload buffer as setup and copying the data as upload
+	void create_input_texture(const DataContainer<T>& input_data, PhaseTimer& timer);
+	void create_output_texture(const DataContainer<T>& input_data);
+	void compute_summed_area_table(const DataContainer<T>& input_data);
+	void readback_output_data(const DataContainer<T>& input_data, DataContainer<T>& output_data);
 
 	// Load and compile shaders and prepare the ShaderProgram structs
 	void setup_shaders();
@@ -0,0 +1,236 @@
+#include "SummedAreaTableOutOfCoreGenerator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "constants.h"
+
+template <typename T>
+SummedAreaTableOutOfCoreGenerator<T>::SummedAreaTableOutOfCoreGenerator(size_t memory_budget, int tile_size)
+	: mMemoryBudget(memory_budget)
+	, mTileSize(tile_size)
+{
+	if (tile_size <= 0)
+	{
+		throw std::runtime_error("Invalid tile size " + std::to_string(tile_size) + ". The tile size needs to be positive");
+	}
+}
+
+template <typename T>
+int SummedAreaTableOutOfCoreGenerator<T>::band_height(int width) const
+{
+	uint64_t row_stride = BinaryDataFile::create_header<T>(width, 1, BinaryPayload::Input).row_stride;
+	return band_height(width, row_stride, row_stride);
+}
+
+template <typename T>
+int SummedAreaTableOutOfCoreGenerator<T>::band_height(int width, uint64_t input_row_stride, uint64_t output_row_stride) const
+{
+	// The column carries and the alignment of both windows don't depend on the band height.
+	// Every band row needs its input and output row with the padding and a row carry
+	size_t fixed_bytes = static_cast<size_t>(width) * sizeof(T) + 2 * MappedFile::allocation_granularity();
+	size_t row_bytes = static_cast<size_t>(input_row_stride + output_row_stride) + sizeof(uint64_t);
+
+	if (mMemoryBudget < fixed_bytes + row_bytes)
+	{
+		throw std::runtime_error("The memory budget of " + std::to_string(mMemoryBudget) + " bytes is too small for rows of "
+			+ std::to_string(width) + " values");
+	}
+
+	size_t rows = (mMemoryBudget - fixed_bytes) / row_bytes;
+	if (rows >= static_cast<size_t>(mTileSize))
+	{
+		rows -= rows % mTileSize; // Whole tiles
+	}
+	return static_cast<int>(std::min<size_t>(rows, INT32_MAX));
+}
+
+template <typename T>
+template <OverflowMode Mode>
+void SummedAreaTableOutOfCoreGenerator<T>::generate_band(const T* input, size_t input_stride, T* output, size_t output_stride, int width,
+	int band_rows, bool first_band)
+{
+	for (int tile_y = 0; tile_y < band_rows; tile_y += mTileSize)
+	{
+		int tile_y_end = std::min(tile_y + mTileSize, band_rows);
+
+		for (int tile_x = 0; tile_x < width; tile_x += mTileSize)
+		{
+			int tile_x_end = std::min(tile_x + mTileSize, width);
+
+			for (int y = tile_y; y < tile_y_end; ++y)
+			{
+				const T* input_row = input + static_cast<size_t>(y) * input_stride;
+				T* output_row = output + static_cast<size_t>(y) * output_stride;
+				const T* previous_output_row = y > 0 ? output_row - output_stride : (first_band ? nullptr : mColumnCarries.data());
+
+				uint64_t row_sum = tile_x > 0 ? mRowCarries[y] : 0;
+				for (int x = tile_x; x < tile_x_end; ++x)
+				{
+					row_sum = reduce_sum<T, Mode>(row_sum + input_row[x]);
+					uint64_t output_value = row_sum;
+					if (previous_output_row != nullptr)
+					{
+						output_value = reduce_sum<T, Mode>(output_value + previous_output_row[x]);
+					}
+					output_row[x] = static_cast<T>(output_value);
+				}
+				mRowCarries[y] = row_sum;
+			}
+		}
+	}
+}
+
+template <typename T>
+TimingReport SummedAreaTableOutOfCoreGenerator<T>::generate(const std::string& input_file, const std::string& output_file)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	BinaryFileHeader input_header = BinaryDataFile::read_header(input_file);
+	if (input_header.num_of_bits != DATA_NUM_OF_BITS<T> || input_header.payload != BinaryPayload::Input)
+	{
+		throw std::runtime_error("The file " + input_file + " isn't a binary input file of " + std::to_string(DATA_NUM_OF_BITS<T>) + " bit data");
+	}
+	int width = static_cast<int>(input_header.width);
+	int height = static_cast<int>(input_header.height);
+	BinaryFileHeader output_header = BinaryDataFile::create_header<T>(width, height, BinaryPayload::SummedAreaTable);
+
+	MappedFile input(input_file, MappedFile::Access::Read);
+	MappedFile output(output_file, MappedFile::Access::ReadWrite, output_header.data_offset + output_header.row_stride * output_header.height);
+	memcpy(output.map(0, sizeof(output_header)), &output_header, sizeof(output_header));
+
+	uint64_t row_bytes = static_cast<uint64_t>(width) * sizeof(T);
+	if (row_bytes > 0 && height > 0)
+	{
+		int rows = std::min(band_height(width, input_header.row_stride, output_header.row_stride), height);
+		mRowCarries.assign(rows, 0);
+		mColumnCarries.assign(width, 0);
+		timer.lap(TIMING_PHASE_SETUP);
+
+		size_t input_stride = static_cast<size_t>(input_header.row_stride / sizeof(T));
+		size_t output_stride = static_cast<size_t>(output_header.row_stride / sizeof(T));
+		for (int band_begin = 0; band_begin < height; band_begin += rows)
+		{
+			// The windows end after the last row of the band, since the last row of the input may not be padded
+			int band_rows = std::min(rows, height - band_begin);
+			const T* band_input = reinterpret_cast<const T*>(input.map(input_header.data_offset + input_header.row_stride * band_begin,
+				static_cast<size_t>(input_header.row_stride * (band_rows - 1) + row_bytes)));
+			T* band_output = reinterpret_cast<T*>(output.map(output_header.data_offset + output_header.row_stride * band_begin,
+				static_cast<size_t>(output_header.row_stride * (band_rows - 1) + row_bytes)));
+			timer.lap(TIMING_PHASE_SETUP);
+
+			dispatch_overflow_mode(mOverflowMode, [&](auto mode_tag)
+			{
+				generate_band<decltype(mode_tag)::value>(band_input, input_stride, band_output, output_stride, width, band_rows, band_begin == 0);
+			});
+
+			const T* last_row = band_output + static_cast<size_t>(band_rows - 1) * output_stride;
+			std::copy(last_row, last_row + width, mColumnCarries.begin());
+			timer.lap(TIMING_PHASE_COMPUTE);
+		}
+	}
+	else
+	{
+		timer.lap(TIMING_PHASE_SETUP);
+	}
+
+	input.unmap();
+	output.unmap();
+	timer.lap(TIMING_PHASE_WRITE);
+	return report;
+}
+
+template <typename T>
+SummedAreaTableFileReader<T>::SummedAreaTableFileReader(const std::string& table_file, int width, int height, size_t window_size)
+	: mTableFile(table_file)
+	, mWidth(width)
+	, mHeight(height)
+	, mWindows(WINDOW_COUNT)
+{
+	BinaryFileHeader header = BinaryDataFile::read_header(table_file);
+	if (header.num_of_bits != DATA_NUM_OF_BITS<T> || header.payload != BinaryPayload::SummedAreaTable)
+	{
+		throw std::runtime_error("The file " + table_file + " isn't a binary table file of " + std::to_string(DATA_NUM_OF_BITS<T>) + " bit data");
+	}
+	if (header.width != static_cast<uint64_t>(width) || header.height != static_cast<uint64_t>(height))
+	{
+		throw std::runtime_error("The table file " + table_file + " has " + std::to_string(header.width) + " x " + std::to_string(header.height)
+			+ " values, but " + std::to_string(width) + " x " + std::to_string(height) + " were expected");
+	}
+	mDataOffset = header.data_offset;
+	mRowStride = header.row_stride;
+
+	mWindowRows = static_cast<int>(std::clamp<uint64_t>(window_size / std::max<uint64_t>(mRowStride, 1), 1, INT32_MAX));
+	for (Window& window : mWindows)
+	{
+		window.file = std::make_unique<MappedFile>(table_file, MappedFile::Access::Read);
+	}
+}
+
+template <typename T>
+T SummedAreaTableFileReader<T>::value(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+	{
+		throw std::runtime_error("Table position (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside the table!");
+	}
+
+	++mUseCounter;
+	for (Window& window : mWindows)
+	{
+		if (window.data != nullptr && y >= window.row_begin && y < window.row_end)
+		{
+			window.last_use = mUseCounter;
+			return window.data[static_cast<size_t>(y - window.row_begin) * (mRowStride / sizeof(T)) + x];
+		}
+	}
+
+	// Map the rows around y into the least recently used window
+	Window& window = *std::min_element(mWindows.begin(), mWindows.end(), [](const Window& a, const Window& b)
+	{
+		return a.last_use < b.last_use;
+	});
+
+	window.row_begin = y - y % mWindowRows;
+	window.row_end = std::min(window.row_begin + mWindowRows, mHeight);
+	uint64_t row_bytes = static_cast<uint64_t>(mWidth) * sizeof(T);
+	window.data = reinterpret_cast<const T*>(window.file->map(mDataOffset + mRowStride * window.row_begin,
+		static_cast<size_t>(mRowStride * (window.row_end - window.row_begin - 1) + row_bytes)));
+	window.last_use = mUseCounter;
+
+	return window.data[static_cast<size_t>(y - window.row_begin) * (mRowStride / sizeof(T)) + x];
+}
+
+template <typename T>
+T SummedAreaTableFileReader<T>::box_sum(const QueryRectangle& rectangle)
+{
+	int64_t x_begin = std::max(rectangle.x, 0);
+	int64_t y_begin = std::max(rectangle.y, 0);
+	int64_t x_end = std::min<int64_t>(static_cast<int64_t>(rectangle.x) + rectangle.width, mWidth);
+	int64_t y_end = std::min<int64_t>(static_cast<int64_t>(rectangle.y) + rectangle.height, mHeight);
+	if (x_begin >= x_end || y_begin >= y_end)
+	{
+		return 0;
+	}
+
+	int x_last = static_cast<int>(x_end - 1);
+	int y_last = static_cast<int>(y_end - 1);
+	int x_before = static_cast<int>(x_begin - 1);
+	int y_before = static_cast<int>(y_begin - 1);
+
+	T bottom_right = value(x_last, y_last);
+	T top_right = y_before >= 0 ? value(x_last, y_before) : 0;
+	T bottom_left = x_before >= 0 ? value(x_before, y_last) : 0;
+	T top_left = x_before >= 0 && y_before >= 0 ? value(x_before, y_before) : 0;
+	return static_cast<T>(bottom_right - top_right - bottom_left + top_left);
+}
+
+template class SummedAreaTableOutOfCoreGenerator<uint8_t>;
+template class SummedAreaTableOutOfCoreGenerator<uint16_t>;
+template class SummedAreaTableOutOfCoreGenerator<uint32_t>;
+
+template class SummedAreaTableFileReader<uint8_t>;
+template class SummedAreaTableFileReader<uint16_t>;
+template class SummedAreaTableFileReader<uint32_t>;
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BinaryDataFile.h"
+#include "MappedFile.h"
+#include "OverflowMode.h"
+#include "SummedAreaTableQuery.h"
+#include "TimingReport.h"
+
+/// Out-of-core summed area table generator for inputs too large for the memory
+/// The input is a binary data file of values of T and the output a binary data file of the table,
+/// see BinaryDataFile. The image is processed in bands of rows, and only the input and output
+/// windows of the current band are mapped, so the memory use stays within the budget however
+/// large the files are. Within a band the tiles are computed row by row, carrying the row sums
+/// from the tile to the left and the last output row of the band above.
+template <typename T>
+class SummedAreaTableOutOfCoreGenerator
+{
+public:
+	// Create the generator with the memory budget in bytes for the mapped windows and the carries,
+	// and the tile size in elements
+	// Will throw std::runtime_error if the tile size isn't positive
+	explicit SummedAreaTableOutOfCoreGenerator(size_t memory_budget = DEFAULT_MEMORY_BUDGET, int tile_size = DEFAULT_TILE_SIZE);
+
+	// Generate the summed area table of the binary input file into a binary table file with rows
+	// aligned like BinaryDataFile::write aligns them.
+	// Returns the time spent opening the files, mapping the band windows, computing the bands and
+	// unmapping the output, which writes the remaining pages back
+	// Will throw std::runtime_error if the input isn't a binary input file of T, the files can't be
+	// mapped, or the budget can't hold a single row of the input and output
+	TimingReport generate(const std::string& input_file, const std::string& output_file);
+
+	// Number of rows in a band for the given width within the memory budget, if the input rows
+	// are aligned like BinaryDataFile::write aligns them
+	// Will throw std::runtime_error if not even one row fits in the budget
+	int band_height(int width) const;
+
+	void set_overflow_mode(OverflowMode mode) { mOverflowMode = mode; }
+	OverflowMode get_overflow_mode() const { return mOverflowMode; }
+
+	static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+	static const int DEFAULT_TILE_SIZE = 256;
+private:
+	// Number of rows in a band for rows of width values that are the given number of bytes apart
+	int band_height(int width, uint64_t input_row_stride, uint64_t output_row_stride) const;
+
+	// Compute the table of a band of rows, whose previous output row is in mColumnCarries.
+	// The strides are the elements from the start of one row to the start of the next
+	template <OverflowMode Mode>
+	void generate_band(const T* input, size_t input_stride, T* output, size_t output_stride, int width, int band_rows, bool first_band);
+
+	size_t mMemoryBudget;
+	int mTileSize;
+	OverflowMode mOverflowMode{OverflowMode::Saturate};
+
+	// Sums of every band row left of the current tile
+	std::vector<uint64_t> mRowCarries;
+	// The last output row of the previous band
+	std::vector<T> mColumnCarries;
+};
+
+/// Random access to a summed area table in a binary data file, like the out-of-core generator writes
+/// A few windows of rows are mapped at a time and the least recently used one is replaced when
+/// a value outside them is read, so the memory use stays bounded by the window size.
+template <typename T>
+class SummedAreaTableFileReader
+{
+public:
+	// Open the table file with the given size. Every window maps about window_size bytes of rows
+	// Will throw std::runtime_error if the file can't be opened, isn't a binary table file of T or
+	// doesn't have the given size
+	SummedAreaTableFileReader(const std::string& table_file, int width, int height, size_t window_size = DEFAULT_WINDOW_SIZE);
+
+	// The table value at (x, y), the sum of the input from (0, 0) to (x, y) inclusive
+	// Will throw std::runtime_error if the position is outside the table
+	T value(int x, int y);
+
+	// Sum of the input values inside the rectangle clamped to the table borders, computed from the
+	// four corners with unsigned wraparound like SummedAreaTableQuery
+	T box_sum(const QueryRectangle& rectangle);
+
+	int width() const { return mWidth; }
+	int height() const { return mHeight; }
+
+	static const size_t DEFAULT_WINDOW_SIZE = 16 * 1024 * 1024;
+	static const int WINDOW_COUNT = 4;
+private:
+	struct Window
+	{
+		std::unique_ptr<MappedFile> file;
+		const T* data{nullptr};
+		int row_begin{0};
+		int row_end{0};
+		uint64_t last_use{0};
+	};
+
+	std::string mTableFile;
+	int mWidth;
+	int mHeight;
+	// Byte offset of the first row and bytes from the start of one row to the start of the next
+	uint64_t mDataOffset{0};
+	uint64_t mRowStride{0};
+	int mWindowRows;
+	std::vector<Window> mWindows;
+	uint64_t mUseCounter{0};
+};
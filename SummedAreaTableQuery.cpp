@@ -0,0 +1,361 @@
+#include "SummedAreaTableQuery.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "SummedAreaTableSimdKernels.h"
+
+// Number of queries evaluated together, one per 32 bit lane
+#ifdef SAT_SIMD_AVX2
+static const int QUERY_BATCH_SIZE = 8;
+#else
+static const int QUERY_BATCH_SIZE = 4;
+#endif
+
+// Width and height of the blocks queries are grouped by in locality order
+static const int QUERY_LOCALITY_BLOCK_SIZE = 64;
+
+template <typename T>
+SummedAreaTableQuery<T>::SummedAreaTableQuery(const DataContainer<T>& table)
+	: SummedAreaTableQuery(table.data.data(), table.width, table.height, static_cast<size_t>(table.width))
+{
+}
+
+template <typename T>
+SummedAreaTableQuery<T>::SummedAreaTableQuery(const T* data, int width, int height, size_t row_stride)
+	: mData(data)
+	, mWidth(width)
+	, mHeight(height)
+	, mRowStride(row_stride)
+{
+	// The table ends after the last element of the last row
+	int64_t size = width > 0 && height > 0 ? static_cast<int64_t>((height - 1) * row_stride + width) : 0;
+	if (size <= std::numeric_limits<int32_t>::max())
+	{
+		mGatherEnd = size - static_cast<int64_t>(4 / sizeof(T) - 1);
+	}
+}
+
+template <typename T>
+typename SummedAreaTableQuery<T>::CornerIndices SummedAreaTableQuery<T>::corner_indices(const QueryRectangle& rectangle) const
+{
+	// Clamp to the table in 64 bits so huge rectangles can't overflow
+	int64_t x_begin = std::max<int64_t>(rectangle.x, 0);
+	int64_t y_begin = std::max<int64_t>(rectangle.y, 0);
+	int64_t x_end = std::min<int64_t>(static_cast<int64_t>(rectangle.x) + rectangle.width, mWidth);
+	int64_t y_end = std::min<int64_t>(static_cast<int64_t>(rectangle.y) + rectangle.height, mHeight);
+
+	if (x_begin >= x_end || y_begin >= y_end)
+	{
+		return { -1, -1, -1, -1 };
+	}
+
+	int64_t stride = static_cast<int64_t>(mRowStride);
+	CornerIndices corners;
+	corners.bottom_right = (y_end - 1) * stride + x_end - 1;
+	corners.top_right = y_begin > 0 ? (y_begin - 1) * stride + x_end - 1 : -1;
+	corners.bottom_left = x_begin > 0 ? (y_end - 1) * stride + x_begin - 1 : -1;
+	corners.top_left = x_begin > 0 && y_begin > 0 ? (y_begin - 1) * stride + x_begin - 1 : -1;
+	return corners;
+}
+
+template <typename T>
+T SummedAreaTableQuery<T>::sum_corners(const CornerIndices& corners) const
+{
+	auto corner_value = [&](int64_t index) -> T
+	{
+		return index >= 0 ? mData[static_cast<size_t>(index)] : 0;
+	};
+	return static_cast<T>(corner_value(corners.bottom_right) - corner_value(corners.top_right)
+		- corner_value(corners.bottom_left) + corner_value(corners.top_left));
+}
+
+template <typename T>
+T SummedAreaTableQuery<T>::box_sum(const QueryRectangle& rectangle) const
+{
+	return sum_corners(corner_indices(rectangle));
+}
+
+template <typename T>
+const char* SummedAreaTableQuery<T>::batch_path_name()
+{
+#if defined(SAT_SIMD_AVX2)
+	return "AVX2 gathers";
+#elif defined(SAT_SIMD_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+template <typename T>
+std::vector<size_t> SummedAreaTableQuery<T>::locality_order(const std::vector<QueryRectangle>& rectangles) const
+{
+	// Counting sort by the block containing the bottom right corner, which is read by every query.
+	// Linear time, so sorting costs less than the cache misses it saves
+	size_t blocks_x = (static_cast<size_t>(mWidth) + QUERY_LOCALITY_BLOCK_SIZE - 1) / QUERY_LOCALITY_BLOCK_SIZE;
+	size_t blocks_y = (static_cast<size_t>(mHeight) + QUERY_LOCALITY_BLOCK_SIZE - 1) / QUERY_LOCALITY_BLOCK_SIZE;
+
+	std::vector<size_t> blocks(rectangles.size());
+	std::vector<size_t> block_offsets(blocks_x * blocks_y + 1, 0);
+	for (size_t i = 0; i < rectangles.size(); ++i)
+	{
+		int64_t bottom_right = corner_indices(rectangles[i]).bottom_right;
+		size_t block = 0;
+		if (bottom_right >= 0)
+		{
+			size_t x = static_cast<size_t>(bottom_right) % mRowStride;
+			size_t y = static_cast<size_t>(bottom_right) / mRowStride;
+			block = (y / QUERY_LOCALITY_BLOCK_SIZE) * blocks_x + x / QUERY_LOCALITY_BLOCK_SIZE;
+		}
+		blocks[i] = block;
+		++block_offsets[block + 1];
+	}
+	for (size_t block = 1; block < block_offsets.size(); ++block)
+	{
+		block_offsets[block] += block_offsets[block - 1];
+	}
+
+	std::vector<size_t> order(rectangles.size());
+	for (size_t i = 0; i < rectangles.size(); ++i)
+	{
+		order[block_offsets[blocks[i]]++] = i;
+	}
+	return order;
+}
+
+#ifdef SAT_SIMD_AVX2
+static_assert(sizeof(QueryRectangle) == 4 * sizeof(int32_t), "QueryRectangle is loaded as four 32 bit integers");
+
+// After the transpose in load_rectangles lane i holds rectangle LANE_RECTANGLES[i] of the batch
+static const int LANE_RECTANGLES[QUERY_BATCH_SIZE] = { 0, 2, 4, 6, 1, 3, 5, 7 };
+
+// Load 8 rectangles and transpose them to vectors of x, y, width and height
+static void load_rectangles(const QueryRectangle* const* batch, __m256i& x, __m256i& y, __m256i& width, __m256i& height)
+{
+	__m256i pairs[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		pairs[i] = _mm256_set_m128i(_mm_loadu_si128(reinterpret_cast<const __m128i*>(batch[2 * i + 1])),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(batch[2 * i])));
+	}
+	__m256i positions_low = _mm256_unpacklo_epi32(pairs[0], pairs[1]);
+	__m256i sizes_low = _mm256_unpackhi_epi32(pairs[0], pairs[1]);
+	__m256i positions_high = _mm256_unpacklo_epi32(pairs[2], pairs[3]);
+	__m256i sizes_high = _mm256_unpackhi_epi32(pairs[2], pairs[3]);
+	x = _mm256_unpacklo_epi64(positions_low, positions_high);
+	y = _mm256_unpackhi_epi64(positions_low, positions_high);
+	width = _mm256_unpacklo_epi64(sizes_low, sizes_high);
+	height = _mm256_unpackhi_epi64(sizes_low, sizes_high);
+}
+
+// End of the range [begin, begin + size) clamped to limit, without overflowing for large sizes.
+// Negative sizes end at begin, so the range is empty
+static __m256i clamped_range_end(__m256i begin, __m256i size, __m256i limit)
+{
+	__m256i negative_size = _mm256_cmpgt_epi32(_mm256_setzero_si256(), size);
+	__m256i end = _mm256_add_epi32(begin, size);
+	__m256i overflow = _mm256_andnot_si256(negative_size, _mm256_cmpgt_epi32(begin, end));
+	end = _mm256_blendv_epi8(_mm256_blendv_epi8(end, limit, overflow), begin, negative_size);
+	return _mm256_min_epi32(end, limit);
+}
+
+// Gather the table values at the indices in the lanes selected by the mask, zero elsewhere.
+// For 8 and 16 bit data the high bits of each lane contain the following elements
+template <typename T>
+static __m256i gather_corners(const T* table, __m256i index, __m256i mask)
+{
+	return _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int*>(table), index, mask, sizeof(T));
+}
+#elif defined(SAT_SIMD_SSE2)
+static_assert(sizeof(QueryRectangle) == 4 * sizeof(int32_t), "QueryRectangle is loaded as four 32 bit integers");
+
+// Lanes of a where the mask is set, lanes of b elsewhere. SSE2 has no blend
+static __m128i select_lanes(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Load 4 rectangles and transpose them to vectors of x, y, width and height, in batch order
+static void load_rectangles(const QueryRectangle* const* batch, __m128i& x, __m128i& y, __m128i& width, __m128i& height)
+{
+	__m128i rectangles[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		rectangles[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(batch[i]));
+	}
+	__m128i positions_low = _mm_unpacklo_epi32(rectangles[0], rectangles[1]);
+	__m128i positions_high = _mm_unpacklo_epi32(rectangles[2], rectangles[3]);
+	__m128i sizes_low = _mm_unpackhi_epi32(rectangles[0], rectangles[1]);
+	__m128i sizes_high = _mm_unpackhi_epi32(rectangles[2], rectangles[3]);
+	x = _mm_unpacklo_epi64(positions_low, positions_high);
+	y = _mm_unpackhi_epi64(positions_low, positions_high);
+	width = _mm_unpacklo_epi64(sizes_low, sizes_high);
+	height = _mm_unpackhi_epi64(sizes_low, sizes_high);
+}
+
+// End of the range [begin, begin + size) clamped to limit, like the AVX2 version with the
+// blends and the minimum built from compares
+static __m128i clamped_range_end(__m128i begin, __m128i size, __m128i limit)
+{
+	__m128i negative_size = _mm_cmpgt_epi32(_mm_setzero_si128(), size);
+	__m128i end = _mm_add_epi32(begin, size);
+	__m128i overflow = _mm_andnot_si128(negative_size, _mm_cmpgt_epi32(begin, end));
+	end = select_lanes(negative_size, begin, select_lanes(overflow, limit, end));
+	return select_lanes(_mm_cmpgt_epi32(end, limit), limit, end);
+}
+#endif
+
+template <typename T>
+void SummedAreaTableQuery<T>::box_sums(const std::vector<QueryRectangle>& rectangles, std::vector<T>& sums, bool sort_by_locality) const
+{
+	sums.resize(rectangles.size());
+
+	std::vector<size_t> order;
+	if (sort_by_locality)
+	{
+		order = locality_order(rectangles);
+	}
+	auto rectangle_index = [&](size_t i)
+	{
+		return order.empty() ? i : order[i];
+	};
+
+	size_t i = 0;
+
+#ifdef SAT_SIMD_AVX2
+	const T* table = mData;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i table_width = _mm256_set1_epi32(mWidth);
+	const __m256i table_height = _mm256_set1_epi32(mHeight);
+	// Only used when the whole table can be gathered, so the stride fits in 32 bits
+	const __m256i row_stride = _mm256_set1_epi32(static_cast<int32_t>(std::min<size_t>(mRowStride, INT32_MAX)));
+	const __m256i gather_end = _mm256_set1_epi32(static_cast<int32_t>(std::max<int64_t>(mGatherEnd, 0)));
+
+	const QueryRectangle* batch[QUERY_BATCH_SIZE];
+	alignas(32) uint32_t batch_sums[QUERY_BATCH_SIZE];
+
+	for (; i + QUERY_BATCH_SIZE <= rectangles.size(); i += QUERY_BATCH_SIZE)
+	{
+		for (int lane = 0; lane < QUERY_BATCH_SIZE; ++lane)
+		{
+			batch[lane] = &rectangles[rectangle_index(i + lane)];
+		}
+
+		__m256i x, y, width, height;
+		load_rectangles(batch, x, y, width, height);
+
+		__m256i x_begin = _mm256_max_epi32(x, zero);
+		__m256i y_begin = _mm256_max_epi32(y, zero);
+		__m256i x_end = clamped_range_end(x, width, table_width);
+		__m256i y_end = clamped_range_end(y, height, table_height);
+
+		// Empty rectangles read no corners, the rest read the corners inside the table
+		__m256i not_empty = _mm256_and_si256(_mm256_cmpgt_epi32(x_end, x_begin), _mm256_cmpgt_epi32(y_end, y_begin));
+		__m256i has_left = _mm256_and_si256(not_empty, _mm256_cmpgt_epi32(x_begin, zero));
+		__m256i has_top = _mm256_and_si256(not_empty, _mm256_cmpgt_epi32(y_begin, zero));
+
+		__m256i x_last = _mm256_sub_epi32(x_end, one);
+		__m256i x_before = _mm256_sub_epi32(x_begin, one);
+		__m256i bottom_row = _mm256_mullo_epi32(_mm256_sub_epi32(y_end, one), row_stride);
+		__m256i top_row = _mm256_mullo_epi32(_mm256_sub_epi32(y_begin, one), row_stride);
+		__m256i bottom_right = _mm256_add_epi32(bottom_row, x_last);
+
+		// The bottom right corner has the largest index of the four
+		__m256i overread = _mm256_and_si256(not_empty, _mm256_cmpgt_epi32(bottom_right, _mm256_sub_epi32(gather_end, one)));
+		if (mGatherEnd <= 0 || !_mm256_testz_si256(overread, overread))
+		{
+			for (int lane = 0; lane < QUERY_BATCH_SIZE; ++lane)
+			{
+				size_t index = rectangle_index(i + lane);
+				sums[index] = box_sum(rectangles[index]);
+			}
+			continue;
+		}
+
+		__m256i sum = gather_corners(table, bottom_right, not_empty);
+		sum = _mm256_sub_epi32(sum, gather_corners(table, _mm256_add_epi32(top_row, x_last), has_top));
+		sum = _mm256_sub_epi32(sum, gather_corners(table, _mm256_add_epi32(bottom_row, x_before), has_left));
+		sum = _mm256_add_epi32(sum, gather_corners(table, _mm256_add_epi32(top_row, x_before), _mm256_and_si256(has_top, has_left)));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(batch_sums), sum);
+
+		// The low bits of the 32 bit sums are the sums modulo 2^bits, whatever the high bits were
+		for (int lane = 0; lane < QUERY_BATCH_SIZE; ++lane)
+		{
+			sums[rectangle_index(i + LANE_RECTANGLES[lane])] = static_cast<T>(batch_sums[lane]);
+		}
+	}
+#elif defined(SAT_SIMD_SSE2)
+	// Without gathers the clamping and the corner masks are computed for 4 rectangles at a time, and the
+	// corners are read with scalar loads. Corners outside the table read element 0 of their row and are
+	// masked to zero, so there are no branches on the rectangle shape
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi32(1);
+	const __m128i table_width = _mm_set1_epi32(mWidth);
+	const __m128i table_height = _mm_set1_epi32(mHeight);
+
+	const QueryRectangle* batch[QUERY_BATCH_SIZE];
+	alignas(16) int32_t x_last[QUERY_BATCH_SIZE];
+	alignas(16) int32_t x_before[QUERY_BATCH_SIZE];
+	alignas(16) int32_t y_last[QUERY_BATCH_SIZE];
+	alignas(16) int32_t y_before[QUERY_BATCH_SIZE];
+	alignas(16) uint32_t not_empty_masks[QUERY_BATCH_SIZE];
+	alignas(16) uint32_t left_masks[QUERY_BATCH_SIZE];
+	alignas(16) uint32_t top_masks[QUERY_BATCH_SIZE];
+
+	// An empty table has no element to read for the masked corners
+	size_t batch_end = mWidth > 0 && mHeight > 0 ? rectangles.size() : 0;
+	for (; i + QUERY_BATCH_SIZE <= batch_end; i += QUERY_BATCH_SIZE)
+	{
+		for (int lane = 0; lane < QUERY_BATCH_SIZE; ++lane)
+		{
+			batch[lane] = &rectangles[rectangle_index(i + lane)];
+		}
+
+		__m128i x, y, width, height;
+		load_rectangles(batch, x, y, width, height);
+
+		__m128i x_begin = _mm_andnot_si128(_mm_cmpgt_epi32(zero, x), x);
+		__m128i y_begin = _mm_andnot_si128(_mm_cmpgt_epi32(zero, y), y);
+		__m128i x_end = clamped_range_end(x, width, table_width);
+		__m128i y_end = clamped_range_end(y, height, table_height);
+
+		__m128i not_empty = _mm_and_si128(_mm_cmpgt_epi32(x_end, x_begin), _mm_cmpgt_epi32(y_end, y_begin));
+		__m128i has_left = _mm_and_si128(not_empty, _mm_cmpgt_epi32(x_begin, zero));
+		__m128i has_top = _mm_and_si128(not_empty, _mm_cmpgt_epi32(y_begin, zero));
+
+		// Masked coordinates are zero, which is inside the table
+		_mm_store_si128(reinterpret_cast<__m128i*>(x_last), _mm_and_si128(not_empty, _mm_sub_epi32(x_end, one)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(x_before), _mm_and_si128(has_left, _mm_sub_epi32(x_begin, one)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(y_last), _mm_and_si128(not_empty, _mm_sub_epi32(y_end, one)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(y_before), _mm_and_si128(has_top, _mm_sub_epi32(y_begin, one)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(not_empty_masks), not_empty);
+		_mm_store_si128(reinterpret_cast<__m128i*>(left_masks), has_left);
+		_mm_store_si128(reinterpret_cast<__m128i*>(top_masks), has_top);
+
+		for (int lane = 0; lane < QUERY_BATCH_SIZE; ++lane)
+		{
+			const T* bottom_row = mData + static_cast<size_t>(y_last[lane]) * mRowStride;
+			const T* top_row = mData + static_cast<size_t>(y_before[lane]) * mRowStride;
+			T not_empty_mask = static_cast<T>(not_empty_masks[lane]);
+			T left_mask = static_cast<T>(left_masks[lane]);
+			T top_mask = static_cast<T>(top_masks[lane]);
+
+			T sum = static_cast<T>((bottom_row[x_last[lane]] & not_empty_mask) - (top_row[x_last[lane]] & top_mask)
+				- (bottom_row[x_before[lane]] & left_mask) + (top_row[x_before[lane]] & left_mask & top_mask));
+			sums[rectangle_index(i + lane)] = sum;
+		}
+	}
+#endif
+
+	for (; i < rectangles.size(); ++i)
+	{
+		size_t index = rectangle_index(i);
+		sums[index] = box_sum(rectangles[index]);
+	}
+}
+
+template class SummedAreaTableQuery<uint8_t>;
+template class SummedAreaTableQuery<uint16_t>;
+template class SummedAreaTableQuery<uint32_t>;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DataContainer.h"
+
+// Rectangle of the input data for a box sum query. Parts outside the table are ignored
+struct QueryRectangle
+{
+	int x{0};
+	int y{0};
+	int width{0};
+	int height{0};
+};
+
+/// Box sum queries against a summed area table produced by a generator
+/// Every query reads the four corners D - B - C + A of its rectangle. The sum is computed with
+/// unsigned wraparound in T, so it is exact for tables generated with OverflowMode::Wrap whenever
+/// the true box sum fits in T, and for OverflowMode::Saturate while the corner D isn't clamped.
+/// Batches of queries gather the four corners of 8 rectangles at a time with AVX2. With SSE2 the
+/// rectangles of a batch are clamped 4 at a time and their corners read with masked scalar loads.
+/// The table isn't copied and needs to outlive the query object.
+template <typename T>
+class SummedAreaTableQuery
+{
+public:
+	explicit SummedAreaTableQuery(const DataContainer<T>& table);
+
+	// Query a table whose row y starts at data + y * row_stride, like a MappedDataView
+	SummedAreaTableQuery(const T* data, int width, int height, size_t row_stride);
+
+	// Sum of the input values inside the rectangle clamped to the table borders.
+	// An empty rectangle sums to zero
+	T box_sum(const QueryRectangle& rectangle) const;
+
+	// Box sums of all the rectangles into sums, in the same order as the rectangles.
+	// With sort_by_locality the rectangles are evaluated grouped by the 64 x 64 block of the table
+	// their bottom right corner is in, so queries close to each other share cache lines
+	void box_sums(const std::vector<QueryRectangle>& rectangles, std::vector<T>& sums, bool sort_by_locality = false) const;
+
+	// Name of the path box_sums() was compiled with: "AVX2 gathers", "SSE2" or "scalar"
+	static const char* batch_path_name();
+
+private:
+	// Table indices of the corners of a clamped rectangle, or -1 for corners outside the table
+	// which count as zero. Every index is -1 for an empty rectangle
+	struct CornerIndices
+	{
+		int64_t bottom_right;
+		int64_t top_right;
+		int64_t bottom_left;
+		int64_t top_left;
+	};
+
+	CornerIndices corner_indices(const QueryRectangle& rectangle) const;
+
+	T sum_corners(const CornerIndices& corners) const;
+
+	// Indices of the rectangles grouped by the table block of their bottom right corners
+	std::vector<size_t> locality_order(const std::vector<QueryRectangle>& rectangles) const;
+
+	const T* mData;
+	int mWidth;
+	int mHeight;
+	// Elements from the start of one row to the start of the next
+	size_t mRowStride;
+
+	// Gathers load 32 bits from every corner, so for 8 and 16 bit data the last elements of the
+	// table can only be read with scalar loads. Corners before this index can be gathered
+	int64_t mGatherEnd{0};
+};
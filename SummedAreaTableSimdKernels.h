@@ -0,0 +1,691 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "OverflowMode.h"
+
+// SIMD kernels for computing summed area table rows with saturating or wrapping arithmetic.
+// AVX2 is used when the compiler targets it (SAT_ENABLE_AVX2 in CMake), SSE2 otherwise.
+// Without either, SAT_SIMD_AVAILABLE is not defined and callers need a scalar path.
+#if defined(__AVX2__)
+#define SAT_SIMD_AVAILABLE
+#define SAT_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAT_SIMD_AVAILABLE
+#define SAT_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef SAT_SIMD_AVAILABLE
+
+// Vector operations for each supported element type. The row prefix sum is done inside a
+// register with log2(lanes) shift and add steps. With OverflowMode::Saturate all additions
+// saturate at the type maximum, which gives the same result as the clamped reference because
+// min(min(a, max) + b, max) == min(a + b, max) for unsigned values.
+template <typename T>
+struct SimdOps;
+
+#ifdef SAT_SIMD_AVX2
+
+typedef __m256i simd_vector_t;
+
+inline simd_vector_t simd_zero()
+{
+	return _mm256_setzero_si256();
+}
+
+inline simd_vector_t simd_load(const void* address)
+{
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(address));
+}
+
+inline void simd_store(void* address, simd_vector_t value)
+{
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(address), value);
+}
+
+// Move the low 128 bit lane to the high lane and zero the low lane
+inline simd_vector_t simd_low_lane_to_high(simd_vector_t value)
+{
+	return _mm256_permute2x128_si256(value, value, 0x08);
+}
+
+inline simd_vector_t simd_or(simd_vector_t a, simd_vector_t b)
+{
+	return _mm256_or_si256(a, b);
+}
+
+// Shift the whole vector towards the higher addresses by Bytes, shifting in zeros.
+// Unlike _mm256_slli_si256 the bytes cross from the low 128 bit lane to the high one
+template <int Bytes>
+inline simd_vector_t simd_shift_left_bytes(simd_vector_t value)
+{
+	if constexpr (Bytes == 0)
+	{
+		return value;
+	}
+	else if constexpr (Bytes < 16)
+	{
+		return _mm256_alignr_epi8(value, simd_low_lane_to_high(value), 16 - Bytes);
+	}
+	else
+	{
+		return _mm256_slli_si256(simd_low_lane_to_high(value), Bytes - 16);
+	}
+}
+
+// Shift the whole vector towards the lower addresses by Bytes, shifting in zeros
+template <int Bytes>
+inline simd_vector_t simd_shift_right_bytes(simd_vector_t value)
+{
+	simd_vector_t high_lane_to_low = _mm256_permute2x128_si256(value, value, 0x81);
+	if constexpr (Bytes == 0)
+	{
+		return value;
+	}
+	else if constexpr (Bytes < 16)
+	{
+		return _mm256_alignr_epi8(high_lane_to_low, value, Bytes);
+	}
+	else
+	{
+		return _mm256_srli_si256(high_lane_to_low, Bytes - 16);
+	}
+}
+
+template <>
+struct SimdOps<uint8_t>
+{
+	static const int LANES = 32;
+
+	static simd_vector_t add_saturated(simd_vector_t a, simd_vector_t b) { return _mm256_adds_epu8(a, b); }
+
+	static simd_vector_t add_wrapping(simd_vector_t a, simd_vector_t b) { return _mm256_add_epi8(a, b); }
+
+	template <OverflowMode Mode>
+	static simd_vector_t add(simd_vector_t a, simd_vector_t b)
+	{
+		return Mode == OverflowMode::Saturate ? add_saturated(a, b) : add_wrapping(a, b);
+	}
+
+	template <OverflowMode Mode>
+	static simd_vector_t prefix_sum(simd_vector_t value)
+	{
+		value = add<Mode>(value, _mm256_slli_si256(value, 1));
+		value = add<Mode>(value, _mm256_slli_si256(value, 2));
+		value = add<Mode>(value, _mm256_slli_si256(value, 4));
+		value = add<Mode>(value, _mm256_slli_si256(value, 8));
+		// Carry the last element of the low lane into the high lane
+		simd_vector_t carry = _mm256_shuffle_epi8(simd_low_lane_to_high(value), _mm256_set1_epi8(15));
+		return add<Mode>(value, carry);
+	}
+
+	static simd_vector_t broadcast_last(simd_vector_t value)
+	{
+		value = _mm256_shuffle_epi8(value, _mm256_set1_epi8(15));
+		return _mm256_permute2x128_si256(value, value, 0x11);
+	}
+};
+
+template <>
+struct SimdOps<uint16_t>
+{
+	static const int LANES = 16;
+
+	static simd_vector_t add_saturated(simd_vector_t a, simd_vector_t b) { return _mm256_adds_epu16(a, b); }
+
+	static simd_vector_t add_wrapping(simd_vector_t a, simd_vector_t b) { return _mm256_add_epi16(a, b); }
+
+	template <OverflowMode Mode>
+	static simd_vector_t add(simd_vector_t a, simd_vector_t b)
+	{
+		return Mode == OverflowMode::Saturate ? add_saturated(a, b) : add_wrapping(a, b);
+	}
+
+	template <OverflowMode Mode>
+	static simd_vector_t prefix_sum(simd_vector_t value)
+	{
+		value = add<Mode>(value, _mm256_slli_si256(value, 2));
+		value = add<Mode>(value, _mm256_slli_si256(value, 4));
+		value = add<Mode>(value, _mm256_slli_si256(value, 8));
+		return add<Mode>(value, broadcast_last_in_lane(simd_low_lane_to_high(value)));
+	}
+
+	static simd_vector_t broadcast_last(simd_vector_t value)
+	{
+		value = broadcast_last_in_lane(value);
+		return _mm256_permute2x128_si256(value, value, 0x11);
+	}
+
+	static simd_vector_t broadcast_last_in_lane(simd_vector_t value)
+	{
+		value = _mm256_shufflehi_epi16(value, 0xFF);
+		return _mm256_unpackhi_epi64(value, value);
+	}
+};
+
+template <>
+struct SimdOps<uint32_t>
+{
+	static const int LANES = 8;
+
+	// There is no unsigned saturating 32 bit add, so detect the wraparound instead
+	static simd_vector_t add_saturated(simd_vector_t a, simd_vector_t b)
+	{
+		const simd_vector_t sign_bit = _mm256_set1_epi32(INT32_MIN);
+		simd_vector_t sum = _mm256_add_epi32(a, b);
+		simd_vector_t overflow = _mm256_cmpgt_epi32(_mm256_xor_si256(a, sign_bit), _mm256_xor_si256(sum, sign_bit));
+		return _mm256_or_si256(sum, overflow);
+	}
+
+	static simd_vector_t add_wrapping(simd_vector_t a, simd_vector_t b) { return _mm256_add_epi32(a, b); }
+
+	template <OverflowMode Mode>
+	static simd_vector_t add(simd_vector_t a, simd_vector_t b)
+	{
+		return Mode == OverflowMode::Saturate ? add_saturated(a, b) : add_wrapping(a, b);
+	}
+
+	template <OverflowMode Mode>
+	static simd_vector_t prefix_sum(simd_vector_t value)
+	{
+		value = add<Mode>(value, _mm256_slli_si256(value, 4));
+		value = add<Mode>(value, _mm256_slli_si256(value, 8));
+		return add<Mode>(value, _mm256_shuffle_epi32(simd_low_lane_to_high(value), 0xFF));
+	}
+
+	static simd_vector_t broadcast_last(simd_vector_t value)
+	{
+		return _mm256_permutevar8x32_epi32(value, _mm256_set1_epi32(7));
+	}
+};
+
+// Operations on 64 bit lanes for the sum and squared sum tables, which always wrap around
+struct SimdWideOps
+{
+	static const int LANES = 4;
+
+	// Load LANES values of T, zero extended to 64 bits
+	template <typename T>
+	static simd_vector_t load_widened(const T* address)
+	{
+		if constexpr (sizeof(T) == 1)
+		{
+			int32_t bits;
+			memcpy(&bits, address, sizeof(bits));
+			return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bits));
+		}
+		else if constexpr (sizeof(T) == 2)
+		{
+			return _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(address)));
+		}
+		else
+		{
+			return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(address)));
+		}
+	}
+
+	static simd_vector_t add(simd_vector_t a, simd_vector_t b) { return _mm256_add_epi64(a, b); }
+
+	// Square of every lane, which needs to be below 2^32
+	static simd_vector_t square(simd_vector_t value) { return _mm256_mul_epu32(value, value); }
+
+	static simd_vector_t prefix_sum(simd_vector_t value)
+	{
+		value = add(value, simd_shift_left_bytes<8>(value));
+		return add(value, simd_shift_left_bytes<16>(value));
+	}
+
+	static simd_vector_t broadcast_last(simd_vector_t value) { return _mm256_permute4x64_epi64(value, 0xFF); }
+};
+
+#else // SSE2
+
+typedef __m128i simd_vector_t;
+
+inline simd_vector_t simd_zero()
+{
+	return _mm_setzero_si128();
+}
+
+inline simd_vector_t simd_load(const void* address)
+{
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(address));
+}
+
+inline void simd_store(void* address, simd_vector_t value)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(address), value);
+}
+
+inline simd_vector_t simd_or(simd_vector_t a, simd_vector_t b)
+{
+	return _mm_or_si128(a, b);
+}
+
+// Shift the whole vector towards the higher addresses by Bytes, shifting in zeros
+template <int Bytes>
+inline simd_vector_t simd_shift_left_bytes(simd_vector_t value)
+{
+	return _mm_slli_si128(value, Bytes);
+}
+
+// Shift the whole vector towards the lower addresses by Bytes, shifting in zeros
+template <int Bytes>
+inline simd_vector_t simd_shift_right_bytes(simd_vector_t value)
+{
+	return _mm_srli_si128(value, Bytes);
+}
+
+template <>
+struct SimdOps<uint8_t>
+{
+	static const int LANES = 16;
+
+	static simd_vector_t add_saturated(simd_vector_t a, simd_vector_t b) { return _mm_adds_epu8(a, b); }
+
+	static simd_vector_t add_wrapping(simd_vector_t a, simd_vector_t b) { return _mm_add_epi8(a, b); }
+
+	template <OverflowMode Mode>
+	static simd_vector_t add(simd_vector_t a, simd_vector_t b)
+	{
+		return Mode == OverflowMode::Saturate ? add_saturated(a, b) : add_wrapping(a, b);
+	}
+
+	template <OverflowMode Mode>
+	static simd_vector_t prefix_sum(simd_vector_t value)
+	{
+		value = add<Mode>(value, _mm_slli_si128(value, 1));
+		value = add<Mode>(value, _mm_slli_si128(value, 2));
+		value = add<Mode>(value, _mm_slli_si128(value, 4));
+		return add<Mode>(value, _mm_slli_si128(value, 8));
+	}
+
+	static simd_vector_t broadcast_last(simd_vector_t value)
+	{
+		value = _mm_unpackhi_epi8(value, value);
+		value = _mm_shufflehi_epi16(value, 0xFF);
+		return _mm_unpackhi_epi64(value, value);
+	}
+};
+
+template <>
+struct SimdOps<uint16_t>
+{
+	static const int LANES = 8;
+
+	static simd_vector_t add_saturated(simd_vector_t a, simd_vector_t b) { return _mm_adds_epu16(a, b); }
+
+	static simd_vector_t add_wrapping(simd_vector_t a, simd_vector_t b) { return _mm_add_epi16(a, b); }
+
+	template <OverflowMode Mode>
+	static simd_vector_t add(simd_vector_t a, simd_vector_t b)
+	{
+		return Mode == OverflowMode::Saturate ? add_saturated(a, b) : add_wrapping(a, b);
+	}
+
+	template <OverflowMode Mode>
+	static simd_vector_t prefix_sum(simd_vector_t value)
+	{
+		value = add<Mode>(value, _mm_slli_si128(value, 2));
+		value = add<Mode>(value, _mm_slli_si128(value, 4));
+		return add<Mode>(value, _mm_slli_si128(value, 8));
+	}
+
+	static simd_vector_t broadcast_last(simd_vector_t value)
+	{
+		value = _mm_shufflehi_epi16(value, 0xFF);
+		return _mm_unpackhi_epi64(value, value);
+	}
+};
+
+template <>
+struct SimdOps<uint32_t>
+{
+	static const int LANES = 4;
+
+	// There is no unsigned saturating 32 bit add, so detect the wraparound instead
+	static simd_vector_t add_saturated(simd_vector_t a, simd_vector_t b)
+	{
+		const simd_vector_t sign_bit = _mm_set1_epi32(INT32_MIN);
+		simd_vector_t sum = _mm_add_epi32(a, b);
+		simd_vector_t overflow = _mm_cmpgt_epi32(_mm_xor_si128(a, sign_bit), _mm_xor_si128(sum, sign_bit));
+		return _mm_or_si128(sum, overflow);
+	}
+
+	static simd_vector_t add_wrapping(simd_vector_t a, simd_vector_t b) { return _mm_add_epi32(a, b); }
+
+	template <OverflowMode Mode>
+	static simd_vector_t add(simd_vector_t a, simd_vector_t b)
+	{
+		return Mode == OverflowMode::Saturate ? add_saturated(a, b) : add_wrapping(a, b);
+	}
+
+	template <OverflowMode Mode>
+	static simd_vector_t prefix_sum(simd_vector_t value)
+	{
+		value = add<Mode>(value, _mm_slli_si128(value, 4));
+		return add<Mode>(value, _mm_slli_si128(value, 8));
+	}
+
+	static simd_vector_t broadcast_last(simd_vector_t value)
+	{
+		return _mm_shuffle_epi32(value, 0xFF);
+	}
+};
+
+// Operations on 64 bit lanes for the sum and squared sum tables, which always wrap around
+struct SimdWideOps
+{
+	static const int LANES = 2;
+
+	// Load LANES values of T, zero extended to 64 bits
+	template <typename T>
+	static simd_vector_t load_widened(const T* address)
+	{
+		const simd_vector_t zero = _mm_setzero_si128();
+		if constexpr (sizeof(T) == 1)
+		{
+			uint16_t bits;
+			memcpy(&bits, address, sizeof(bits));
+			simd_vector_t value = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bits), zero);
+			return _mm_unpacklo_epi32(_mm_unpacklo_epi16(value, zero), zero);
+		}
+		else if constexpr (sizeof(T) == 2)
+		{
+			int32_t bits;
+			memcpy(&bits, address, sizeof(bits));
+			return _mm_unpacklo_epi32(_mm_unpacklo_epi16(_mm_cvtsi32_si128(bits), zero), zero);
+		}
+		else
+		{
+			return _mm_unpacklo_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(address)), zero);
+		}
+	}
+
+	static simd_vector_t add(simd_vector_t a, simd_vector_t b) { return _mm_add_epi64(a, b); }
+
+	// Square of every lane, which needs to be below 2^32
+	static simd_vector_t square(simd_vector_t value) { return _mm_mul_epu32(value, value); }
+
+	static simd_vector_t prefix_sum(simd_vector_t value) { return add(value, _mm_slli_si128(value, 8)); }
+
+	static simd_vector_t broadcast_last(simd_vector_t value) { return _mm_unpackhi_epi64(value, value); }
+};
+
+#endif // SAT_SIMD_AVX2
+
+// Compute one row of the summed area table: the prefix sum of input_row added to
+// previous_output_row (the row above in the output, or nullptr for the first row)
+template <typename T, OverflowMode Mode>
+void summed_area_table_row_simd(const T* input_row, const T* previous_output_row, T* output_row, int width)
+{
+	typedef SimdOps<T> Ops;
+
+	simd_vector_t carry = simd_zero();
+	int x = 0;
+
+	for (; x + Ops::LANES <= width; x += Ops::LANES)
+	{
+		simd_vector_t row_sum = Ops::template add<Mode>(Ops::template prefix_sum<Mode>(simd_load(input_row + x)), carry);
+		carry = Ops::broadcast_last(row_sum);
+
+		if (previous_output_row != nullptr)
+		{
+			row_sum = Ops::template add<Mode>(row_sum, simd_load(previous_output_row + x));
+		}
+		simd_store(output_row + x, row_sum);
+	}
+
+	// Finish the remaining elements with scalar code, continuing from the vector carry
+	T carry_values[Ops::LANES];
+	simd_store(carry_values, carry);
+	uint64_t current_sum = carry_values[0];
+
+	for (; x < width; ++x)
+	{
+		current_sum = reduce_sum<T, Mode>(current_sum + input_row[x]);
+		uint64_t output_value = current_sum;
+		if (previous_output_row != nullptr)
+		{
+			output_value = reduce_sum<T, Mode>(output_value + previous_output_row[x]);
+		}
+		output_row[x] = static_cast<T>(output_value);
+	}
+}
+
+// Prefix sum of every channel of interleaved pixels inside a register: lane i gets the sum of the
+// lanes i, i - Channels, i - 2 * Channels and so on
+template <typename T, OverflowMode Mode, int Channels, int Shift = Channels>
+simd_vector_t strided_prefix_sum(simd_vector_t value)
+{
+	if constexpr (Shift >= SimdOps<T>::LANES)
+	{
+		return value;
+	}
+	else
+	{
+		value = SimdOps<T>::template add<Mode>(value, simd_shift_left_bytes<Shift * sizeof(T)>(value));
+		return strided_prefix_sum<T, Mode, Channels, Shift * 2>(value);
+	}
+}
+
+// Repeat the last Channels lanes over the whole vector, so lane i gets lane LANES - Channels + i % Channels.
+// As the vectors of a row start LANES elements apart, that lane has the same channel as lane i of the next
+// vector, even when Channels doesn't divide LANES like for RGB
+template <typename T, int Channels>
+simd_vector_t repeat_last_pixel(simd_vector_t value)
+{
+	value = simd_shift_right_bytes<(SimdOps<T>::LANES - Channels) * sizeof(T)>(value);
+	if constexpr (Channels < SimdOps<T>::LANES)
+	{
+		value = simd_or(value, simd_shift_left_bytes<Channels * sizeof(T)>(value));
+	}
+	if constexpr (2 * Channels < SimdOps<T>::LANES)
+	{
+		value = simd_or(value, simd_shift_left_bytes<2 * Channels * sizeof(T)>(value));
+	}
+	if constexpr (4 * Channels < SimdOps<T>::LANES)
+	{
+		value = simd_or(value, simd_shift_left_bytes<4 * Channels * sizeof(T)>(value));
+	}
+	if constexpr (8 * Channels < SimdOps<T>::LANES)
+	{
+		value = simd_or(value, simd_shift_left_bytes<8 * Channels * sizeof(T)>(value));
+	}
+	if constexpr (16 * Channels < SimdOps<T>::LANES)
+	{
+		value = simd_or(value, simd_shift_left_bytes<16 * Channels * sizeof(T)>(value));
+	}
+	return value;
+}
+
+// Compute one row of the summed area tables of every channel of interleaved pixels. The channels map to
+// the vector lanes, so all of them are summed in the same instructions. width is in pixels
+template <typename T, OverflowMode Mode, int Channels>
+void summed_area_table_row_channels_simd(const T* input_row, const T* previous_output_row, T* output_row, int width)
+{
+	static_assert(Channels <= SimdOps<T>::LANES, "Every channel of a pixel needs to fit in one vector");
+	typedef SimdOps<T> Ops;
+
+	int count = width * Channels;
+	simd_vector_t carry = simd_zero();
+	int x = 0;
+
+	for (; x + Ops::LANES <= count; x += Ops::LANES)
+	{
+		simd_vector_t row_sum = Ops::template add<Mode>(strided_prefix_sum<T, Mode, Channels>(simd_load(input_row + x)), carry);
+		carry = repeat_last_pixel<T, Channels>(row_sum);
+
+		if (previous_output_row != nullptr)
+		{
+			row_sum = Ops::template add<Mode>(row_sum, simd_load(previous_output_row + x));
+		}
+		simd_store(output_row + x, row_sum);
+	}
+
+	// Finish the remaining elements with scalar code. Lane i of the carry holds the sum of the channel of element x + i
+	T carry_values[Ops::LANES];
+	simd_store(carry_values, carry);
+	uint64_t current_sums[Channels];
+	for (int channel = 0; channel < Channels; ++channel)
+	{
+		current_sums[(x + channel) % Channels] = carry_values[channel];
+	}
+
+	for (; x < count; ++x)
+	{
+		uint64_t& current_sum = current_sums[x % Channels];
+		current_sum = reduce_sum<T, Mode>(current_sum + input_row[x]);
+		uint64_t output_value = current_sum;
+		if (previous_output_row != nullptr)
+		{
+			output_value = reduce_sum<T, Mode>(output_value + previous_output_row[x]);
+		}
+		output_row[x] = static_cast<T>(output_value);
+	}
+}
+
+// Compute one row of the summed area tables of the input and of its squares in one pass over the input.
+// The input is widened to 64 bit lanes, so both tables are exact modulo 2^64
+template <typename T>
+void sum_and_square_row_simd(const T* input_row, const uint64_t* previous_sums_row, const uint64_t* previous_squares_row,
+	uint64_t* sums_row, uint64_t* squares_row, int width)
+{
+	typedef SimdWideOps Ops;
+
+	simd_vector_t sum_carry = simd_zero();
+	simd_vector_t square_carry = simd_zero();
+	int x = 0;
+
+	for (; x + Ops::LANES <= width; x += Ops::LANES)
+	{
+		simd_vector_t values = Ops::load_widened(input_row + x);
+		simd_vector_t sums = Ops::add(Ops::prefix_sum(values), sum_carry);
+		simd_vector_t squares = Ops::add(Ops::prefix_sum(Ops::square(values)), square_carry);
+		sum_carry = Ops::broadcast_last(sums);
+		square_carry = Ops::broadcast_last(squares);
+
+		if (previous_sums_row != nullptr)
+		{
+			sums = Ops::add(sums, simd_load(previous_sums_row + x));
+			squares = Ops::add(squares, simd_load(previous_squares_row + x));
+		}
+		simd_store(sums_row + x, sums);
+		simd_store(squares_row + x, squares);
+	}
+
+	// Finish the remaining elements with scalar code, continuing from the vector carries
+	uint64_t carry_values[Ops::LANES];
+	simd_store(carry_values, sum_carry);
+	uint64_t current_sum = carry_values[0];
+	simd_store(carry_values, square_carry);
+	uint64_t current_square_sum = carry_values[0];
+
+	for (; x < width; ++x)
+	{
+		uint64_t value = input_row[x];
+		current_sum += value;
+		current_square_sum += value * value;
+		sums_row[x] = current_sum + (previous_sums_row != nullptr ? previous_sums_row[x] : 0);
+		squares_row[x] = current_square_sum + (previous_squares_row != nullptr ? previous_squares_row[x] : 0);
+	}
+}
+
+#endif // SAT_SIMD_AVAILABLE
+
+// Compute one row of the summed area table with the SIMD kernel, or with scalar code when
+// the build doesn't target SSE2 or AVX2
+template <typename T, OverflowMode Mode>
+void summed_area_table_row(const T* input_row, const T* previous_output_row, T* output_row, int width)
+{
+#ifdef SAT_SIMD_AVAILABLE
+	summed_area_table_row_simd<T, Mode>(input_row, previous_output_row, output_row, width);
+#else
+	uint64_t current_sum = 0;
+	for (int x = 0; x < width; ++x)
+	{
+		current_sum = reduce_sum<T, Mode>(current_sum + input_row[x]);
+		uint64_t output_value = current_sum;
+		if (previous_output_row != nullptr)
+		{
+			output_value = reduce_sum<T, Mode>(output_value + previous_output_row[x]);
+		}
+		output_row[x] = static_cast<T>(output_value);
+	}
+#endif
+}
+
+// Compute one row of the summed area tables of every channel of interleaved pixels with the SIMD kernel,
+// or with scalar code when the build doesn't target SSE2 or AVX2. width is in pixels
+template <typename T, OverflowMode Mode, int Channels>
+void summed_area_table_row_channels(const T* input_row, const T* previous_output_row, T* output_row, int width)
+{
+#ifdef SAT_SIMD_AVAILABLE
+	summed_area_table_row_channels_simd<T, Mode, Channels>(input_row, previous_output_row, output_row, width);
+#else
+	uint64_t current_sums[Channels] = {};
+	for (int x = 0; x < width * Channels; ++x)
+	{
+		uint64_t& current_sum = current_sums[x % Channels];
+		current_sum = reduce_sum<T, Mode>(current_sum + input_row[x]);
+		uint64_t output_value = current_sum;
+		if (previous_output_row != nullptr)
+		{
+			output_value = reduce_sum<T, Mode>(output_value + previous_output_row[x]);
+		}
+		output_row[x] = static_cast<T>(output_value);
+	}
+#endif
+}
+
+// Add values to sums element by element, like the previous slice of a summed volume table to the next one
+template <typename T, OverflowMode Mode>
+void accumulate_values(const T* values, T* sums, size_t count)
+{
+	size_t i = 0;
+#ifdef SAT_SIMD_AVAILABLE
+	for (; i + SimdOps<T>::LANES <= count; i += SimdOps<T>::LANES)
+	{
+		simd_store(sums + i, SimdOps<T>::template add<Mode>(simd_load(sums + i), simd_load(values + i)));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		sums[i] = static_cast<T>(reduce_sum<T, Mode>(static_cast<uint64_t>(sums[i]) + values[i]));
+	}
+}
+
+// Compute one row of the summed area tables of the input and of its squares with scalar code
+template <typename T>
+void sum_and_square_row_scalar(const T* input_row, const uint64_t* previous_sums_row, const uint64_t* previous_squares_row,
+	uint64_t* sums_row, uint64_t* squares_row, int width)
+{
+	uint64_t current_sum = 0;
+	uint64_t current_square_sum = 0;
+	for (int x = 0; x < width; ++x)
+	{
+		uint64_t value = input_row[x];
+		current_sum += value;
+		current_square_sum += value * value;
+		sums_row[x] = current_sum + (previous_sums_row != nullptr ? previous_sums_row[x] : 0);
+		squares_row[x] = current_square_sum + (previous_squares_row != nullptr ? previous_squares_row[x] : 0);
+	}
+}
+
+// Compute one row of the summed area tables of the input and of its squares with the SIMD kernel,
+// or with scalar code when the build doesn't target SSE2 or AVX2
+template <typename T>
+void sum_and_square_row(const T* input_row, const uint64_t* previous_sums_row, const uint64_t* previous_squares_row,
+	uint64_t* sums_row, uint64_t* squares_row, int width)
+{
+#ifdef SAT_SIMD_AVAILABLE
+	sum_and_square_row_simd<T>(input_row, previous_sums_row, previous_squares_row, sums_row, squares_row, width);
+#else
+	sum_and_square_row_scalar<T>(input_row, previous_sums_row, previous_squares_row, sums_row, squares_row, width);
+#endif
+}
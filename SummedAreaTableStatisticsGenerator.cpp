@@ -0,0 +1,55 @@
+#include "SummedAreaTableStatisticsGenerator.h"
+
+#include "SummedAreaTableSimdKernels.h"
+
+template <typename T>
+SummedAreaTableStatisticsGenerator<T>::SummedAreaTableStatisticsGenerator(bool use_simd)
+	: mUseSimd(use_simd)
+{
+}
+
+template <typename T>
+void SummedAreaTableStatisticsGenerator<T>::generate_rows(const DataContainer<T>& data_in, StatisticsTables& tables_out, int row_begin, int row_end) const
+{
+	int width = data_in.width;
+	for (int y = row_begin; y < row_end; ++y)
+	{
+		size_t row_offset = static_cast<size_t>(y) * width;
+		const T* input_row = data_in.data.data() + row_offset;
+		uint64_t* sums_row = tables_out.sums.data() + row_offset;
+		uint64_t* squares_row = tables_out.squared_sums.data() + row_offset;
+		const uint64_t* previous_sums_row = y > row_begin ? sums_row - width : nullptr;
+		const uint64_t* previous_squares_row = y > row_begin ? squares_row - width : nullptr;
+
+		if (mUseSimd)
+		{
+			sum_and_square_row<T>(input_row, previous_sums_row, previous_squares_row, sums_row, squares_row, width);
+		}
+		else
+		{
+			sum_and_square_row_scalar<T>(input_row, previous_sums_row, previous_squares_row, sums_row, squares_row, width);
+		}
+	}
+}
+
+template <typename T>
+TimingReport SummedAreaTableStatisticsGenerator<T>::generate(const DataContainer<T>& data_in, StatisticsTables& tables_out)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	tables_out.sums.resize(data_in.data.size());
+	tables_out.squared_sums.resize(data_in.data.size());
+	tables_out.width = data_in.width;
+	tables_out.height = data_in.height;
+	timer.lap(TIMING_PHASE_ALLOCATE);
+
+	generate_rows(data_in, tables_out, 0, data_in.height);
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
+}
+
+template class SummedAreaTableStatisticsGenerator<uint8_t>;
+template class SummedAreaTableStatisticsGenerator<uint16_t>;
+template class SummedAreaTableStatisticsGenerator<uint32_t>;
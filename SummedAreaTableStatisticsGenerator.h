@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "DataContainer.h"
+#include "TimingReport.h"
+
+// Summed area tables of an input and of its squares, for the mean and variance of any rectangle like
+// Viola-Jones normalization and Sauvola thresholding need. Both tables are 64 bit and wrap around, so
+// box sums are exact whenever the true sum fits in 64 bits: always for 8 and 16 bit inputs up to
+// 2^32 elements, and for 32 bit inputs while the squares of the box do
+struct StatisticsTables
+{
+	int width{0};
+	int height{0};
+	std::vector<uint64_t> sums;
+	std::vector<uint64_t> squared_sums;
+};
+
+/// Generates the summed area tables of the input and of its squares in one pass over the input,
+/// instead of generating the two tables one after the other and reading the input twice.
+/// The SIMD kernel widens the input to 64 bit lanes and sums the values and their squares in the
+/// same loop. See SummedAreaTableBatchGenerator::generate_statistics for many images at once.
+template <typename T>
+class SummedAreaTableStatisticsGenerator
+{
+public:
+	// Use the SIMD kernel, or the scalar one for comparison. Builds without SSE2 or AVX2 always use the scalar kernel
+	explicit SummedAreaTableStatisticsGenerator(bool use_simd = true);
+
+	// Generate both tables of data_in into tables_out
+	// Returns the durations of allocating the tables and of the computation
+	TimingReport generate(const DataContainer<T>& data_in, StatisticsTables& tables_out);
+
+	// Generate both tables of the rows [row_begin, row_end) as if they were a whole image. The tables need the size of the input
+	void generate_rows(const DataContainer<T>& data_in, StatisticsTables& tables_out, int row_begin, int row_end) const;
+private:
+	bool mUseSimd;
+};
@@ -0,0 +1,59 @@
+#include "SummedAreaTableStatisticsQuery.h"
+
+#include <algorithm>
+
+SummedAreaTableStatisticsQuery::SummedAreaTableStatisticsQuery(const StatisticsTables& tables)
+	: mTables(tables)
+{
+}
+
+RegionStatistics SummedAreaTableStatisticsQuery::statistics(const QueryRectangle& rectangle) const
+{
+	// Clamp to the table in 64 bits so huge rectangles can't overflow
+	int64_t x_begin = std::max<int64_t>(rectangle.x, 0);
+	int64_t y_begin = std::max<int64_t>(rectangle.y, 0);
+	int64_t x_end = std::min<int64_t>(static_cast<int64_t>(rectangle.x) + rectangle.width, mTables.width);
+	int64_t y_end = std::min<int64_t>(static_cast<int64_t>(rectangle.y) + rectangle.height, mTables.height);
+
+	RegionStatistics result;
+	if (x_begin >= x_end || y_begin >= y_end)
+	{
+		return result;
+	}
+
+	// D - B - C + A in both tables with unsigned wraparound, where corners before the table count as zero
+	int64_t width = mTables.width;
+	auto box_sum = [&](const std::vector<uint64_t>& table) -> uint64_t
+	{
+		uint64_t sum = table[(y_end - 1) * width + x_end - 1];
+		if (y_begin > 0)
+		{
+			sum -= table[(y_begin - 1) * width + x_end - 1];
+		}
+		if (x_begin > 0)
+		{
+			sum -= table[(y_end - 1) * width + x_begin - 1];
+		}
+		if (x_begin > 0 && y_begin > 0)
+		{
+			sum += table[(y_begin - 1) * width + x_begin - 1];
+		}
+		return sum;
+	};
+
+	result.count = static_cast<uint64_t>((x_end - x_begin) * (y_end - y_begin));
+	result.sum = box_sum(mTables.sums);
+	result.squared_sum = box_sum(mTables.squared_sums);
+	result.mean = static_cast<double>(result.sum) / result.count;
+	result.variance = std::max(0.0, static_cast<double>(result.squared_sum) / result.count - result.mean * result.mean);
+	return result;
+}
+
+void SummedAreaTableStatisticsQuery::statistics(const std::vector<QueryRectangle>& rectangles, std::vector<RegionStatistics>& results) const
+{
+	results.resize(rectangles.size());
+	for (size_t i = 0; i < rectangles.size(); ++i)
+	{
+		results[i] = statistics(rectangles[i]);
+	}
+}
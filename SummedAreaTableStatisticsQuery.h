@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "SummedAreaTableQuery.h"
+#include "SummedAreaTableStatisticsGenerator.h"
+
+// Mean and population variance of the input values of a rectangle
+struct RegionStatistics
+{
+	// Number of elements in the rectangle clamped to the table, 0 for an empty rectangle
+	uint64_t count{0};
+	uint64_t sum{0};
+	uint64_t squared_sum{0};
+	double mean{0.0};
+	double variance{0.0};
+};
+
+/// Mean and variance queries against the tables of a SummedAreaTableStatisticsGenerator in constant time
+/// Every query reads the four corners of its rectangle in both tables. The variance is computed as
+/// squared_sum / count - mean^2 in double precision and clamped at zero against rounding.
+/// The tables aren't copied and need to outlive the query object.
+class SummedAreaTableStatisticsQuery
+{
+public:
+	explicit SummedAreaTableStatisticsQuery(const StatisticsTables& tables);
+
+	// Statistics of the input values inside the rectangle clamped to the table borders
+	RegionStatistics statistics(const QueryRectangle& rectangle) const;
+
+	// Statistics of all the rectangles, in the same order as the rectangles
+	void statistics(const std::vector<QueryRectangle>& rectangles, std::vector<RegionStatistics>& results) const;
+private:
+	const StatisticsTables& mTables;
+};
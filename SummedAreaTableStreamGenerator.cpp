@@ -0,0 +1,84 @@
+#include "SummedAreaTableStreamGenerator.h"
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+
+#include "constants.h"
+#include "SummedAreaTableSimdKernels.h"
+
+template <typename T>
+void SummedAreaTableStreamGenerator<T>::reset(int width)
+{
+	mWidth = width;
+	mRows.assign(2 * static_cast<size_t>(width), 0);
+	mRowCount = 0;
+}
+
+template <typename T>
+const T* SummedAreaTableStreamGenerator<T>::generate_row(const T* input_row)
+{
+	// The output row alternates between the halves of the row buffer
+	T* output_row = mRows.data() + (mRowCount % 2) * static_cast<size_t>(mWidth);
+	const T* previous_output_row = mRowCount > 0 ? mRows.data() + ((mRowCount + 1) % 2) * static_cast<size_t>(mWidth) : nullptr;
+
+	dispatch_overflow_mode(mOverflowMode, [&](auto mode_tag)
+	{
+		summed_area_table_row<T, decltype(mode_tag)::value>(input_row, previous_output_row, output_row, mWidth);
+	});
+
+	++mRowCount;
+	return output_row;
+}
+
+template <typename T>
+TimingReport SummedAreaTableStreamGenerator<T>::generate(InputRowReader<T>& reader, std::ostream& output)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	std::vector<T> input_row;
+	std::string text;
+
+	while (reader.read_row(input_row))
+	{
+		if (reader.rows_read() == 1)
+		{
+			reset(reader.width());
+			// Every value takes at most its maximum length and a separator
+			text.resize(static_cast<size_t>(mWidth) * (DATA_MAX_STRING_LENGTH<T> + 1) + 1);
+		}
+		timer.lap(TIMING_PHASE_READ);
+
+		const T* output_row = generate_row(input_row.data());
+		timer.lap(TIMING_PHASE_COMPUTE);
+
+		char* text_end = text.data();
+		for (int x = 0; x < mWidth; ++x)
+		{
+			if (x > 0)
+			{
+				*text_end++ = ' ';
+			}
+			text_end = std::to_chars(text_end, text.data() + text.size(), output_row[x]).ptr;
+		}
+		*text_end++ = '\n';
+		output.write(text.data(), text_end - text.data());
+		timer.lap(TIMING_PHASE_WRITE);
+	}
+	// The failed read at the end of the input
+	timer.lap(TIMING_PHASE_READ);
+
+	output.flush();
+	if (!output)
+	{
+		throw std::runtime_error("Could not write the summed area table output!");
+	}
+
+	timer.lap(TIMING_PHASE_WRITE);
+	return report;
+}
+
+template class SummedAreaTableStreamGenerator<uint8_t>;
+template class SummedAreaTableStreamGenerator<uint16_t>;
+template class SummedAreaTableStreamGenerator<uint32_t>;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "InputParser.h"
+#include "OverflowMode.h"
+#include "TimingReport.h"
+
+/// Streaming summed area table generator using the CPU
+/// Every output row only depends on its input row and the previous output row, so the table
+/// can be generated one row at a time while keeping just that row as the carry. The working
+/// memory is O(width), independent of the height, and inputs larger than the memory can be
+/// processed at the speed of the disk. Rows are computed with the SIMD row kernel.
+template <typename T>
+class SummedAreaTableStreamGenerator
+{
+public:
+	// Start a new table with rows of the given width
+	void reset(int width);
+
+	// Compute the next row of the table from the next input row, which needs the width given to reset().
+	// Returns the output row, which stays valid until the row after the next one is computed
+	const T* generate_row(const T* input_row);
+
+	// Generate the table of the rows read from the reader, and write it to the output as text with
+	// the values of a row separated by spaces and one row per line.
+	// Returns the time spent reading and parsing, computing and writing the rows, summed over the rows
+	TimingReport generate(InputRowReader<T>& reader, std::ostream& output);
+
+	void set_overflow_mode(OverflowMode mode) { mOverflowMode = mode; }
+	OverflowMode get_overflow_mode() const { return mOverflowMode; }
+private:
+	OverflowMode mOverflowMode{OverflowMode::Saturate};
+
+	// The current and the previous output row. They alternate, so the previous row is never copied
+	std::vector<T> mRows;
+	int mWidth{0};
+	// Rows computed since reset()
+	uint64_t mRowCount{0};
+};
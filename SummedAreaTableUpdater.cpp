@@ -0,0 +1,152 @@
+#include "SummedAreaTableUpdater.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "constants.h"
+#include "ParallelFor.h"
+
+template <typename T>
+SummedAreaTableUpdater<T>::SummedAreaTableUpdater(int thread_count)
+	: mThreadCount(thread_count)
+{
+}
+
+template <typename T>
+template <OverflowMode Mode>
+void SummedAreaTableUpdater<T>::update_region(const DataContainer<T>& data_in, DataContainer<T>& data_out, int first_row)
+{
+	const int width = data_in.width;
+	const int height = data_in.height;
+	const T* input = data_in.data.data();
+	T* output = data_out.data.data();
+	const std::vector<int>& row_starts = mRowStarts;
+
+	// Row prefix sums of the region, stored in the output until the vertical pass
+	parallel_for(height - first_row, mThreadCount, [=, &row_starts](int row_begin, int row_end)
+	{
+		for (int y = first_row + row_begin; y < first_row + row_end; ++y)
+		{
+			const T* input_row = input + static_cast<size_t>(y) * width;
+			T* output_row = output + static_cast<size_t>(y) * width;
+			int x_begin = row_starts[y];
+
+			// The row sum left of the region is the difference of the unchanged table elements left
+			// of it in this row and the row above, which also lie outside the region
+			uint64_t current_sum = 0;
+			if (x_begin > 0)
+			{
+				T left = output_row[x_begin - 1];
+				T above_left = y > 0 ? output_row[x_begin - 1 - width] : 0;
+				if (Mode == OverflowMode::Saturate && left == DATA_MAX_VALUE<T>)
+				{
+					// The true sum is at least the maximum, and so is everything to the right and below
+					current_sum = DATA_MAX_VALUE<T>;
+				}
+				else
+				{
+					// Not clamped, so both values are exact. With wraparound the difference is exact modulo 2^bits
+					current_sum = static_cast<T>(left - above_left);
+				}
+			}
+
+			for (int x = x_begin; x < width; ++x)
+			{
+				current_sum = reduce_sum<T, Mode>(current_sum + input_row[x]);
+				output_row[x] = static_cast<T>(current_sum);
+			}
+		}
+	});
+
+	// Vertical pass over column strips. A column joins the region at the first row starting left
+	// of it, and its running sum starts from the unchanged table element above that row
+	int first_column = row_starts[height - 1];
+	parallel_for(width - first_column, mThreadCount, [=, &row_starts](int strip_begin, int strip_end)
+	{
+		int column_begin = first_column + strip_begin;
+		int column_end = first_column + strip_end;
+		std::vector<uint64_t> current_sums(column_end - column_begin, 0);
+
+		for (int y = first_row; y < height; ++y)
+		{
+			T* output_row = output + static_cast<size_t>(y) * width;
+			int x_begin = std::max(row_starts[y], column_begin);
+			int x_joined = y > 0 ? std::clamp(row_starts[y - 1], x_begin, column_end) : x_begin;
+
+			for (int x = x_begin; x < x_joined; ++x)
+			{
+				current_sums[x - column_begin] = y > 0 ? output_row[x - width] : 0;
+			}
+
+			for (int x = x_begin; x < column_end; ++x)
+			{
+				uint64_t& current_sum = current_sums[x - column_begin];
+				current_sum = reduce_sum<T, Mode>(current_sum + output_row[x]);
+				output_row[x] = static_cast<T>(current_sum);
+			}
+		}
+	});
+}
+
+template <typename T>
+UpdateStatistics SummedAreaTableUpdater<T>::update(const DataContainer<T>& data_in, DataContainer<T>& data_out, const std::vector<QueryRectangle>& dirty_rectangles)
+{
+	if (data_out.width != data_in.width || data_out.height != data_in.height || data_out.data.size() != data_in.data.size())
+	{
+		throw std::runtime_error("The summed area table to update doesn't have the size of the input!");
+	}
+
+	UpdateStatistics statistics;
+	statistics.total_elements = data_in.data.size();
+
+	PhaseTimer timer(statistics.timing);
+
+	// Leftmost dirty column starting at every row, then carried down to the rows below
+	mRowStarts.assign(data_in.height, data_in.width);
+	int first_row = data_in.height;
+	for (const QueryRectangle& rectangle : dirty_rectangles)
+	{
+		int64_t x_begin = std::max(rectangle.x, 0);
+		int64_t y_begin = std::max(rectangle.y, 0);
+		int64_t x_end = std::min<int64_t>(static_cast<int64_t>(rectangle.x) + rectangle.width, data_in.width);
+		int64_t y_end = std::min<int64_t>(static_cast<int64_t>(rectangle.y) + rectangle.height, data_in.height);
+		if (x_begin >= x_end || y_begin >= y_end)
+		{
+			continue;
+		}
+
+		mRowStarts[y_begin] = std::min(mRowStarts[y_begin], static_cast<int>(x_begin));
+		first_row = std::min(first_row, static_cast<int>(y_begin));
+	}
+
+	for (int y = first_row; y < data_in.height; ++y)
+	{
+		if (y > first_row)
+		{
+			mRowStarts[y] = std::min(mRowStarts[y], mRowStarts[y - 1]);
+		}
+		statistics.updated_elements += data_in.width - mRowStarts[y];
+	}
+	timer.lap(TIMING_PHASE_SETUP);
+
+	if (statistics.updated_elements > 0)
+	{
+		dispatch_overflow_mode(mOverflowMode, [&](auto mode_tag)
+		{
+			update_region<decltype(mode_tag)::value>(data_in, data_out, first_row);
+		});
+	}
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return statistics;
+}
+
+template <typename T>
+UpdateStatistics SummedAreaTableUpdater<T>::update(const DataContainer<T>& data_in, DataContainer<T>& data_out, const QueryRectangle& dirty_rectangle)
+{
+	return update(data_in, data_out, std::vector<QueryRectangle>{ dirty_rectangle });
+}
+
+template class SummedAreaTableUpdater<uint8_t>;
+template class SummedAreaTableUpdater<uint16_t>;
+template class SummedAreaTableUpdater<uint32_t>;
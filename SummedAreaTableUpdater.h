@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "DataContainer.h"
+#include "OverflowMode.h"
+#include "SummedAreaTableQuery.h"
+#include "TimingReport.h"
+
+// How much of the table an incremental update recomputed
+struct UpdateStatistics
+{
+	size_t updated_elements{0};
+	size_t total_elements{0};
+	// Time spent finding the region to recompute and recomputing it
+	TimingReport timing;
+
+	// Fraction of the work of a full generate() that the update didn't need to do
+	double saved_fraction() const
+	{
+		return total_elements > 0 ? 1.0 - static_cast<double>(updated_elements) / total_elements : 0.0;
+	}
+};
+
+/// Incremental update of a summed area table after parts of the input changed
+/// A changed element only affects the table below and to the right of it, so only the union of
+/// those regions is recomputed. Its left edge is a staircase: every row starts at the leftmost
+/// dirty column at or above it. The update first computes the row prefix sums of the region,
+/// starting from the carry recovered from the unchanged table element to the left, rows split
+/// between the threads. Then it adds the columns up in strips, like the parallel generator.
+template <typename T>
+class SummedAreaTableUpdater
+{
+public:
+	// Create the updater using the given number of threads. 0 uses every hardware thread
+	explicit SummedAreaTableUpdater(int thread_count = 0);
+
+	// Update data_out, the summed area table of the previous input, to the table of data_in after
+	// the elements inside the dirty rectangles changed. Rectangles are clamped to the input.
+	// The overflow mode needs to be the one the table was generated with.
+	// Will throw std::runtime_error if the table doesn't have the size of the input
+	UpdateStatistics update(const DataContainer<T>& data_in, DataContainer<T>& data_out, const std::vector<QueryRectangle>& dirty_rectangles);
+
+	UpdateStatistics update(const DataContainer<T>& data_in, DataContainer<T>& data_out, const QueryRectangle& dirty_rectangle);
+
+	void set_overflow_mode(OverflowMode mode) { mOverflowMode = mode; }
+	OverflowMode get_overflow_mode() const { return mOverflowMode; }
+private:
+	template <OverflowMode Mode>
+	void update_region(const DataContainer<T>& data_in, DataContainer<T>& data_out, int first_row);
+
+	int mThreadCount;
+	OverflowMode mOverflowMode{OverflowMode::Saturate};
+
+	// First column of the recomputed region in every row, the width for rows above the region
+	std::vector<int> mRowStarts;
+};
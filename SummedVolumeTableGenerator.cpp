@@ -0,0 +1,72 @@
+#include "SummedVolumeTableGenerator.h"
+
+#include "constants.h"
+#include "ParallelFor.h"
+#include "SummedAreaTableSimdKernels.h"
+
+template <typename T>
+SummedVolumeTableGenerator<T>::SummedVolumeTableGenerator(int thread_count)
+	: mThreadCount(thread_count)
+{
+}
+
+template <typename T, OverflowMode Mode>
+static void generate_volume(const T* input, T* output, int width, int height, int depth, int thread_count)
+{
+	size_t slice_size = static_cast<size_t>(width) * height;
+
+	// The summed area table of every slice on its own
+	parallel_for(depth, thread_count, [=](int slice_begin, int slice_end)
+	{
+		for (int z = slice_begin; z < slice_end; ++z)
+		{
+			for (int y = 0; y < height; ++y)
+			{
+				size_t row_offset = z * slice_size + static_cast<size_t>(y) * width;
+				T* output_row = output + row_offset;
+				const T* previous_output_row = y > 0 ? output_row - width : nullptr;
+				summed_area_table_row<T, Mode>(input + row_offset, previous_output_row, output_row, width);
+			}
+		}
+	});
+
+	// Slice to slice sweep. Each thread owns a band of rows and walks it through the slices.
+	// Clamping the slice tables first gives the same result as the reference, since
+	// min(min(a, max) + b, max) == min(a + b, max) for unsigned values
+	parallel_for(height, thread_count, [=](int row_begin, int row_end)
+	{
+		size_t band_offset = static_cast<size_t>(row_begin) * width;
+		size_t band_size = static_cast<size_t>(row_end - row_begin) * width;
+		for (int z = 1; z < depth; ++z)
+		{
+			T* band = output + z * slice_size + band_offset;
+			accumulate_values<T, Mode>(band - slice_size, band, band_size);
+		}
+	});
+}
+
+template <typename T>
+TimingReport SummedVolumeTableGenerator<T>::generate(const VolumeContainer<T>& data_in, VolumeContainer<T>& data_out)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	data_out.data.resize(data_in.data.size());
+	data_out.width = data_in.width;
+	data_out.height = data_in.height;
+	data_out.depth = data_in.depth;
+	timer.lap(TIMING_PHASE_ALLOCATE);
+
+	dispatch_overflow_mode(mOverflowMode, [&](auto mode_tag)
+	{
+		generate_volume<T, decltype(mode_tag)::value>(data_in.data.data(), data_out.data.data(),
+			data_in.width, data_in.height, data_in.depth, mThreadCount);
+	});
+
+	timer.lap(TIMING_PHASE_COMPUTE);
+	return report;
+}
+
+template class SummedVolumeTableGenerator<uint8_t>;
+template class SummedVolumeTableGenerator<uint16_t>;
+template class SummedVolumeTableGenerator<uint32_t>;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "DataContainer.h"
+#include "OverflowMode.h"
+#include "TimingReport.h"
+
+/// Multithreaded summed volume table generator using the CPU, the 3D summed area table of a
+/// video clip over (x, y, t) or a volume over (x, y, z)
+/// Extends the row and column sweep of the 2D generators by a slice to slice pass: first the
+/// summed area table of every slice is generated with the SIMD row kernel, slices split between
+/// the threads, and then every slice is added to the one after it, the slices split into bands of
+/// rows between the threads. See SummedVolumeTableStreamGenerator for volumes larger than the memory.
+template <typename T>
+class SummedVolumeTableGenerator
+{
+public:
+	// Create the generator using the given number of threads. 0 uses every hardware thread
+	explicit SummedVolumeTableGenerator(int thread_count = 0);
+
+	// Generate the summed volume table of data_in to data_out
+	// Returns the durations of allocating data_out and of the computation
+	TimingReport generate(const VolumeContainer<T>& data_in, VolumeContainer<T>& data_out);
+
+	// Select how sums larger than the data type maximum are stored. The default is OverflowMode::Saturate
+	void set_overflow_mode(OverflowMode mode) { mOverflowMode = mode; }
+	OverflowMode get_overflow_mode() const { return mOverflowMode; }
+private:
+	int mThreadCount;
+	OverflowMode mOverflowMode{OverflowMode::Saturate};
+};
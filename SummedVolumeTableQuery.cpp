@@ -0,0 +1,64 @@
+#include "SummedVolumeTableQuery.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T>
+SummedVolumeTableQuery<T>::SummedVolumeTableQuery(const VolumeContainer<T>& table)
+	: SummedVolumeTableQuery(table.data.data(), table.width, table.height, table.depth)
+{
+}
+
+template <typename T>
+SummedVolumeTableQuery<T>::SummedVolumeTableQuery(const T* data, int width, int height, int depth)
+	: mData(data)
+	, mWidth(width)
+	, mHeight(height)
+	, mDepth(depth)
+{
+}
+
+template <typename T>
+T SummedVolumeTableQuery<T>::cuboid_sum(const QueryCuboid& cuboid) const
+{
+	// Clamp to the table in 64 bits so huge cuboids can't overflow
+	int64_t x_begin = std::max<int64_t>(cuboid.x, 0);
+	int64_t y_begin = std::max<int64_t>(cuboid.y, 0);
+	int64_t z_begin = std::max<int64_t>(cuboid.z, 0);
+	int64_t x_end = std::min<int64_t>(static_cast<int64_t>(cuboid.x) + cuboid.width, mWidth);
+	int64_t y_end = std::min<int64_t>(static_cast<int64_t>(cuboid.y) + cuboid.height, mHeight);
+	int64_t z_end = std::min<int64_t>(static_cast<int64_t>(cuboid.z) + cuboid.depth, mDepth);
+
+	if (x_begin >= x_end || y_begin >= y_end || z_begin >= z_end)
+	{
+		return 0;
+	}
+
+	// The table value at the inclusive corner, where a coordinate of -1 is before the table and counts as zero
+	auto corner_value = [&](int64_t x, int64_t y, int64_t z) -> T
+	{
+		if (x < 0 || y < 0 || z < 0)
+		{
+			return 0;
+		}
+		return mData[static_cast<size_t>((z * mHeight + y) * mWidth + x)];
+	};
+
+	int64_t x0 = x_begin - 1;
+	int64_t y0 = y_begin - 1;
+	int64_t z0 = z_begin - 1;
+	int64_t x1 = x_end - 1;
+	int64_t y1 = y_end - 1;
+	int64_t z1 = z_end - 1;
+
+	// Inclusion-exclusion over the corners, with the sign given by the number of begin coordinates
+	return static_cast<T>(corner_value(x1, y1, z1)
+		- corner_value(x0, y1, z1) - corner_value(x1, y0, z1) - corner_value(x1, y1, z0)
+		+ corner_value(x0, y0, z1) + corner_value(x0, y1, z0) + corner_value(x1, y0, z0)
+		- corner_value(x0, y0, z0));
+}
+
+template class SummedVolumeTableQuery<uint8_t>;
+template class SummedVolumeTableQuery<uint16_t>;
+template class SummedVolumeTableQuery<uint32_t>;
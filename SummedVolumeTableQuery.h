@@ -0,0 +1,39 @@
+#pragma once
+
+#include "DataContainer.h"
+
+// Cuboid of the input volume for a cuboid sum query. Parts outside the table are ignored
+struct QueryCuboid
+{
+	int x{0};
+	int y{0};
+	int z{0};
+	int width{0};
+	int height{0};
+	int depth{0};
+};
+
+/// Cuboid sum queries against a summed volume table, in constant time
+/// Every query reads the 8 corners of its cuboid and adds and subtracts them by inclusion-exclusion.
+/// Like the box sums of SummedAreaTableQuery the sum is computed with unsigned wraparound in T, so it
+/// is exact for tables generated with OverflowMode::Wrap whenever the true sum fits in T, and for
+/// OverflowMode::Saturate while the far corner isn't clamped.
+/// The table isn't copied and needs to outlive the query object.
+template <typename T>
+class SummedVolumeTableQuery
+{
+public:
+	explicit SummedVolumeTableQuery(const VolumeContainer<T>& table);
+
+	// Query a table of depth slices of width * height values, like SummedVolumeTableStreamGenerator writes
+	SummedVolumeTableQuery(const T* data, int width, int height, int depth);
+
+	// Sum of the input values inside the cuboid clamped to the table borders.
+	// An empty cuboid sums to zero
+	T cuboid_sum(const QueryCuboid& cuboid) const;
+private:
+	const T* mData;
+	int mWidth;
+	int mHeight;
+	int mDepth;
+};
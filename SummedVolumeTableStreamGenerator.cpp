@@ -0,0 +1,100 @@
+#include "SummedVolumeTableStreamGenerator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "constants.h"
+#include "SummedAreaTableSimdKernels.h"
+
+template <typename T>
+void SummedVolumeTableStreamGenerator<T>::reset(int width, int height)
+{
+	mWidth = width;
+	mHeight = height;
+	mPreviousSlice.assign(static_cast<size_t>(width) * height, 0);
+	mSliceRows.assign(2 * static_cast<size_t>(width), 0);
+	mFirstSlice = true;
+}
+
+template <typename T>
+void SummedVolumeTableStreamGenerator<T>::generate_slice(const T* input_slice, T* output_slice)
+{
+	dispatch_overflow_mode(mOverflowMode, [&](auto mode_tag)
+	{
+		constexpr OverflowMode Mode = decltype(mode_tag)::value;
+
+		for (int y = 0; y < mHeight; ++y)
+		{
+			// Row y of the slice table, alternating between the halves of the row buffer
+			T* slice_row = mSliceRows.data() + (y % 2) * static_cast<size_t>(mWidth);
+			const T* previous_slice_row = y > 0 ? mSliceRows.data() + ((y + 1) % 2) * static_cast<size_t>(mWidth) : nullptr;
+			size_t row_offset = static_cast<size_t>(y) * mWidth;
+			summed_area_table_row<T, Mode>(input_slice + row_offset, previous_slice_row, slice_row, mWidth);
+
+			// Adding it to the previous output slice in place makes that the carry for the next slice
+			T* carry_row = mPreviousSlice.data() + row_offset;
+			if (mFirstSlice)
+			{
+				std::copy(slice_row, slice_row + mWidth, carry_row);
+			}
+			else
+			{
+				accumulate_values<T, Mode>(slice_row, carry_row, mWidth);
+			}
+			std::copy(carry_row, carry_row + mWidth, output_slice + row_offset);
+		}
+	});
+
+	mFirstSlice = false;
+}
+
+template <typename T>
+TimingReport SummedVolumeTableStreamGenerator<T>::generate(const std::string& input_file, int width, int height, int depth, const std::string& output_file)
+{
+	TimingReport report;
+	PhaseTimer timer(report);
+
+	std::ifstream input(input_file, std::ios::binary);
+	if (!input)
+	{
+		throw std::runtime_error("Could not open the volume input file " + input_file);
+	}
+	std::ofstream output(output_file, std::ios::binary);
+	if (!output)
+	{
+		throw std::runtime_error("Could not open the volume output file " + output_file);
+	}
+
+	reset(width, height);
+	size_t slice_bytes = static_cast<size_t>(width) * height * sizeof(T);
+	std::vector<T> input_slice(static_cast<size_t>(width) * height);
+	std::vector<T> output_slice(input_slice.size());
+	timer.lap(TIMING_PHASE_SETUP);
+
+	for (int z = 0; z < depth; ++z)
+	{
+		if (!input.read(reinterpret_cast<char*>(input_slice.data()), slice_bytes))
+		{
+			throw std::runtime_error("The volume input file " + input_file + " ends before slice " + std::to_string(z));
+		}
+		timer.lap(TIMING_PHASE_READ);
+		generate_slice(input_slice.data(), output_slice.data());
+		timer.lap(TIMING_PHASE_COMPUTE);
+		output.write(reinterpret_cast<const char*>(output_slice.data()), slice_bytes);
+		timer.lap(TIMING_PHASE_WRITE);
+	}
+
+	output.flush();
+	if (!output)
+	{
+		throw std::runtime_error("Could not write the volume output file " + output_file);
+	}
+
+	timer.lap(TIMING_PHASE_WRITE);
+	return report;
+}
+
+template class SummedVolumeTableStreamGenerator<uint8_t>;
+template class SummedVolumeTableStreamGenerator<uint16_t>;
+template class SummedVolumeTableStreamGenerator<uint32_t>;
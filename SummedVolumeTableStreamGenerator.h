@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "OverflowMode.h"
+#include "TimingReport.h"
+
+/// Streaming summed volume table generator using the CPU
+/// Every output slice only depends on its input slice and the previous output slice, so the table
+/// can be generated one slice at a time, like frames arriving from a video decoder, while keeping
+/// just that slice as the carry. The working memory is O(width * height), independent of the depth.
+template <typename T>
+class SummedVolumeTableStreamGenerator
+{
+public:
+	// Start a new table with slices of the given width and height
+	void reset(int width, int height);
+
+	// Compute the next slice of the table from the next input slice. Both slices need the size given to reset()
+	void generate_slice(const T* input_slice, T* output_slice);
+
+	// Generate the table of a raw file of depth slices of width * height values of T into a raw output
+	// file, reading and writing one slice at a time. Returns the time spent opening the files and allocating
+	// the slices, and reading, computing and writing the slices, summed over the slices
+	// Will throw a std::runtime_error if the files can't be opened or the input is too short
+	TimingReport generate(const std::string& input_file, int width, int height, int depth, const std::string& output_file);
+
+	void set_overflow_mode(OverflowMode mode) { mOverflowMode = mode; }
+	OverflowMode get_overflow_mode() const { return mOverflowMode; }
+private:
+	OverflowMode mOverflowMode{OverflowMode::Saturate};
+
+	// The previous output slice
+	std::vector<T> mPreviousSlice;
+	// The current and previous row of the summed area table of the current slice
+	std::vector<T> mSliceRows;
+	int mWidth{0};
+	int mHeight{0};
+	bool mFirstSlice{true};
+};
@@ -0,0 +1,144 @@
+#include "SyntheticInput.h"
+
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+#include "BinaryDataFile.h"
+#include "InputParser.h"
+#include "ParallelFor.h"
+
+static const uint64_t SPARSE_PERCENT = 1;
+static const uint64_t SATURATING_RANGE = 16;
+
+// SplitMix64 finalizer of the seed and the element index. Every element gets its own well mixed
+// random value without a sequential generator state, so rows can be generated in any order
+static uint64_t hash_element(uint64_t seed, uint64_t index)
+{
+	uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+const std::vector<std::string>& SyntheticInput::pattern_names()
+{
+	static const std::vector<std::string> names = { "constant", "ramp", "random", "sparse", "saturating" };
+	return names;
+}
+
+SyntheticPattern SyntheticInput::parse_pattern(const std::string& name)
+{
+	const std::vector<std::string>& names = pattern_names();
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		if (names[i] == name)
+		{
+			return static_cast<SyntheticPattern>(i);
+		}
+	}
+	throw std::runtime_error("Unknown synthetic input pattern " + name);
+}
+
+std::string SyntheticInput::pattern_name(SyntheticPattern pattern)
+{
+	return pattern_names()[static_cast<size_t>(pattern)];
+}
+
+template <typename T>
+void SyntheticInput::generate(const SyntheticInputSettings& settings, DataContainer<T>& data_out, int thread_count)
+{
+	if (settings.width <= 0 || settings.height <= 0)
+	{
+		throw std::runtime_error("Invalid synthetic input size " + std::to_string(settings.width) + " x " + std::to_string(settings.height));
+	}
+	if (static_cast<uint64_t>(settings.width) * settings.height > InputParser::max_input_values<T>())
+	{
+		throw std::runtime_error("The synthetic input is too large for the memory of this computer! The maximum is "
+			+ std::to_string(InputParser::max_input_values<T>()) + " values");
+	}
+
+	int width = settings.width;
+	data_out.width = width;
+	data_out.height = settings.height;
+	data_out.data.resize(static_cast<size_t>(width) * settings.height);
+
+	parallel_for(settings.height, thread_count, [&](int begin, int end)
+	{
+		for (int y = begin; y < end; ++y)
+		{
+			size_t row = static_cast<size_t>(y) * width;
+			T* values = data_out.data.data() + row;
+			for (int x = 0; x < width; ++x)
+			{
+				switch (settings.pattern)
+				{
+					case SyntheticPattern::Constant:
+						values[x] = 1;
+						break;
+					case SyntheticPattern::Ramp:
+						values[x] = static_cast<T>(static_cast<uint64_t>(x) + y);
+						break;
+					case SyntheticPattern::Random:
+						values[x] = static_cast<T>(hash_element(settings.seed, row + x));
+						break;
+					case SyntheticPattern::Sparse:
+					{
+						uint64_t hash = hash_element(settings.seed, row + x);
+						values[x] = (hash >> 32) % 100 < SPARSE_PERCENT ? static_cast<T>(hash | 1) : 0;
+						break;
+					}
+					case SyntheticPattern::Saturating:
+						values[x] = static_cast<T>(DATA_MAX_VALUE<T> - hash_element(settings.seed, row + x) % SATURATING_RANGE);
+						break;
+				}
+			}
+		}
+	});
+}
+
+template <typename T>
+void SyntheticInput::write_file(const std::string& path, const DataContainer<T>& data)
+{
+	std::string extension = BINARY_FILE_EXTENSION;
+	if (path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0)
+	{
+		BinaryDataFile::write(path, data, BinaryPayload::Input);
+		return;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		throw std::runtime_error("Could not open the synthetic input file for writing: " + path);
+	}
+
+	// Format a row at a time into a buffer, which is much faster than writing the values to the stream
+	std::string line;
+	char number[24];
+	for (int y = 0; y < data.height; ++y)
+	{
+		line.clear();
+		const T* values = data.data.data() + static_cast<size_t>(y) * data.width;
+		for (int x = 0; x < data.width; ++x)
+		{
+			char* number_end = std::to_chars(number, number + sizeof(number), values[x]).ptr;
+			line.append(number, number_end);
+			line += x + 1 < data.width ? ' ' : '\n';
+		}
+		file.write(line.data(), static_cast<std::streamsize>(line.size()));
+	}
+
+	if (!file)
+	{
+		throw std::runtime_error("Could not write the synthetic input file: " + path);
+	}
+}
+
+template void SyntheticInput::generate<uint8_t>(const SyntheticInputSettings&, DataContainer<uint8_t>&, int);
+template void SyntheticInput::generate<uint16_t>(const SyntheticInputSettings&, DataContainer<uint16_t>&, int);
+template void SyntheticInput::generate<uint32_t>(const SyntheticInputSettings&, DataContainer<uint32_t>&, int);
+
+template void SyntheticInput::write_file<uint8_t>(const std::string&, const DataContainer<uint8_t>&);
+template void SyntheticInput::write_file<uint16_t>(const std::string&, const DataContainer<uint16_t>&);
+template void SyntheticInput::write_file<uint32_t>(const std::string&, const DataContainer<uint32_t>&);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DataContainer.h"
+
+// Value patterns of the synthetic inputs
+enum class SyntheticPattern
+{
+	// Every value is 1, so every table value is the area of its rectangle
+	Constant,
+	// Values grow by one to the right and down, wrapping around at the data type maximum
+	Ramp,
+	// Uniformly random values over the whole data type range
+	Random,
+	// About one value in a hundred is a random nonzero value, the rest are 0
+	Sparse,
+	// Random values within 16 of the data type maximum, so the sums saturate almost immediately
+	Saturating
+};
+
+struct SyntheticInputSettings
+{
+	SyntheticPattern pattern{SyntheticPattern::Random};
+	int width{1024};
+	int height{1024};
+	// The same seed, pattern and size always give the same values
+	uint64_t seed{0};
+};
+
+/// Source of synthetic inputs of any size, for benchmarking without text files
+/// The values are computed from a hash of the seed and the element index, so they don't depend on
+/// the number of threads and a run can be reproduced from its settings or from a file written by write_file.
+class SyntheticInput
+{
+public:
+	// Names of the patterns for the command line, in the order of SyntheticPattern
+	static const std::vector<std::string>& pattern_names();
+
+	// Will throw a std::runtime_error if there is no pattern with the name
+	static SyntheticPattern parse_pattern(const std::string& name);
+	static std::string pattern_name(SyntheticPattern pattern);
+
+	// Fill data_out with the pattern, using the given number of threads (0 uses every hardware thread)
+	// Will throw a std::runtime_error if the size is invalid
+	template <typename T>
+	static void generate(const SyntheticInputSettings& settings, DataContainer<T>& data_out, int thread_count = 1);
+
+	// Write the data to a file that parse_input_file reads back: a binary data file if the path ends in
+	// BINARY_FILE_EXTENSION, else a text file of space separated values
+	// Will throw a std::runtime_error if the file can't be written
+	template <typename T>
+	static void write_file(const std::string& path, const DataContainer<T>& data);
+
+	static constexpr const char* BINARY_FILE_EXTENSION = ".satb";
+};
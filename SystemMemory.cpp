@@ -0,0 +1,29 @@
+#include "SystemMemory.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+uint64_t physical_memory_size()
+{
+#ifdef _WIN32
+	MEMORYSTATUSEX memory_status;
+	memory_status.dwLength = sizeof(memory_status);
+	if (!GlobalMemoryStatusEx(&memory_status))
+	{
+		return UINT64_MAX;
+	}
+	return memory_status.ullTotalPhys;
+#else
+	long pages = sysconf(_SC_PHYS_PAGES);
+	long page_size = sysconf(_SC_PAGE_SIZE);
+	if (pages <= 0 || page_size <= 0)
+	{
+		return UINT64_MAX;
+	}
+	return static_cast<uint64_t>(pages) * static_cast<uint64_t>(page_size);
+#endif
+}
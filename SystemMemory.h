@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+// Size of the physical memory of this computer in bytes, or UINT64_MAX if it can't be queried
+uint64_t physical_memory_size();
@@ -0,0 +1,106 @@
+#include "ThreadPool.h"
+
+#include "ParallelFor.h"
+
+ThreadPool::ThreadPool(int thread_count)
+{
+	int worker_count = resolve_thread_count(thread_count) - 1;
+	mThreads.reserve(worker_count);
+	for (int i = 0; i < worker_count; ++i)
+	{
+		mThreads.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mBatchStarted.notify_all();
+
+	for (std::thread& thread : mThreads)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::run(int task_count, const std::function<void(int)>& function)
+{
+	if (task_count <= 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFunction = &function;
+		mTaskCount = task_count;
+		mNextTask = 0;
+		mException = nullptr;
+		mBusyWorkers = static_cast<int>(mThreads.size());
+		++mBatch;
+	}
+	mBatchStarted.notify_all();
+
+	run_tasks();
+
+	// Every worker has to check in, so none of them still runs this batch when the next one starts
+	std::unique_lock<std::mutex> lock(mMutex);
+	mBatchFinished.wait(lock, [this] { return mBusyWorkers == 0; });
+	mFunction = nullptr;
+
+	if (mException)
+	{
+		std::exception_ptr exception = mException;
+		mException = nullptr;
+		std::rethrow_exception(exception);
+	}
+}
+
+void ThreadPool::work()
+{
+	uint64_t finished_batch = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mBatchStarted.wait(lock, [&] { return mStopping || mBatch != finished_batch; });
+			if (mStopping)
+			{
+				return;
+			}
+			finished_batch = mBatch;
+		}
+
+		run_tasks();
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (--mBusyWorkers == 0)
+		{
+			mBatchFinished.notify_one();
+		}
+	}
+}
+
+void ThreadPool::run_tasks()
+{
+	for (int task = mNextTask++; task < mTaskCount; task = mNextTask++)
+	{
+		try
+		{
+			(*mFunction)(task);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (!mException)
+			{
+				mException = std::current_exception();
+			}
+			// Skip the remaining tasks
+			mNextTask = mTaskCount;
+		}
+	}
+}
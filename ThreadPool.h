@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed set of worker threads that run batches of indexed tasks
+/// Unlike parallel_for, the threads are started once and reused, so many small batches don't pay
+/// for starting threads every time. Tasks are handed out one index at a time, which balances
+/// tasks of different sizes. The calling thread works on the batch as well.
+/// run() isn't reentrant and shouldn't be called from several threads at once.
+class ThreadPool
+{
+public:
+	// Start the pool for the given number of threads including the calling thread. 0 uses every hardware thread
+	explicit ThreadPool(int thread_count = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Number of threads running the tasks, including the calling thread
+	int thread_count() const { return static_cast<int>(mThreads.size()) + 1; }
+
+	// Run function(task) for every task in [0, task_count) and return once all of them have finished.
+	// If a task throws, the tasks that haven't started yet are skipped and the first exception is rethrown
+	void run(int task_count, const std::function<void(int)>& function);
+private:
+	void work();
+	void run_tasks();
+
+	std::vector<std::thread> mThreads;
+	std::mutex mMutex;
+	std::condition_variable mBatchStarted;
+	std::condition_variable mBatchFinished;
+
+	// The running batch. Written under the mutex before mBatch is incremented
+	const std::function<void(int)>* mFunction{nullptr};
+	int mTaskCount{0};
+	std::atomic<int> mNextTask{0};
+	std::exception_ptr mException;
+
+	// Incremented for every batch, so the workers can tell a new batch from a spurious wakeup
+	uint64_t mBatch{0};
+	// Workers that haven't finished the running batch yet
+	int mBusyWorkers{0};
+	bool mStopping{false};
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "PerformanceCounters.h"
+
+// Names of the phases the generators report
+static const std::string TIMING_PHASE_ALLOCATE = "allocate";
+static const std::string TIMING_PHASE_SETUP = "setup";
+static const std::string TIMING_PHASE_UPLOAD = "upload";
+static const std::string TIMING_PHASE_COMPUTE = "compute";
+static const std::string TIMING_PHASE_READBACK = "readback";
+static const std::string TIMING_PHASE_CACHE_HASH = "cache hash";
+static const std::string TIMING_PHASE_CACHE_LOAD = "cache load";
+static const std::string TIMING_PHASE_CACHE_STORE = "cache store";
+static const std::string TIMING_PHASE_READ = "read";
+static const std::string TIMING_PHASE_WRITE = "write";
+
+struct TimingPhase
+{
+	std::string name;
+	int64_t nanoseconds{0};
+	// Hardware event counts of the phase, if performance counters were active while it ran
+	bool has_counters{false};
+	CounterValues counters;
+};
+
+/// Durations of the named phases of a generator run in nanoseconds, in the order they first ran
+class TimingReport
+{
+public:
+	// Add the duration and counts to the phase with the name, appending the phase if it's new
+	void add(const TimingPhase& added_phase)
+	{
+		for (TimingPhase& phase : mPhases)
+		{
+			if (phase.name == added_phase.name)
+			{
+				phase.nanoseconds += added_phase.nanoseconds;
+				phase.has_counters = phase.has_counters || added_phase.has_counters;
+				phase.counters += added_phase.counters;
+				return;
+			}
+		}
+		mPhases.push_back(added_phase);
+	}
+
+	void add(const std::string& name, int64_t nanoseconds)
+	{
+		TimingPhase phase;
+		phase.name = name;
+		phase.nanoseconds = nanoseconds;
+		add(phase);
+	}
+
+	// Add every phase of another report, like the report of a wrapped generator
+	void add(const TimingReport& report)
+	{
+		for (const TimingPhase& phase : report.mPhases)
+		{
+			add(phase);
+		}
+	}
+
+	// Duration of the phase with the name, 0 if it didn't run
+	int64_t phase(const std::string& name) const
+	{
+		for (const TimingPhase& phase : mPhases)
+		{
+			if (phase.name == name)
+			{
+				return phase.nanoseconds;
+			}
+		}
+		return 0;
+	}
+
+	int64_t total() const
+	{
+		int64_t nanoseconds = 0;
+		for (const TimingPhase& phase : mPhases)
+		{
+			nanoseconds += phase.nanoseconds;
+		}
+		return nanoseconds;
+	}
+
+	// Whether any phase has hardware event counts
+	bool has_counters() const
+	{
+		for (const TimingPhase& phase : mPhases)
+		{
+			if (phase.has_counters)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Hardware event counts of every phase
+	CounterValues total_counters() const
+	{
+		CounterValues counters;
+		for (const TimingPhase& phase : mPhases)
+		{
+			counters += phase.counters;
+		}
+		return counters;
+	}
+
+	// Total duration of every phase in milliseconds
+	float total_milliseconds() const { return to_milliseconds(total()); }
+
+	const std::vector<TimingPhase>& phases() const { return mPhases; }
+
+	static float to_milliseconds(int64_t nanoseconds) { return static_cast<float>(nanoseconds / 1.0e6); }
+private:
+	std::vector<TimingPhase> mPhases;
+};
+
+/// Times consecutive phases into a TimingReport with the steady clock
+/// The first phase starts at construction and every lap() ends the running phase and starts the next one.
+/// If performance counters are active on the thread, the phases also get their hardware event counts.
+class PhaseTimer
+{
+public:
+	explicit PhaseTimer(TimingReport& report)
+		: mReport(report)
+		, mCounters(PerformanceCounters::active())
+	{
+		restart();
+	}
+
+	// End the running phase, adding its duration to the report under the name, and start the next one
+	void lap(const std::string& name)
+	{
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		TimingPhase phase;
+		phase.name = name;
+		phase.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now - mStart).count();
+		if (mCounters != nullptr)
+		{
+			CounterValues counters = mCounters->read();
+			phase.has_counters = true;
+			phase.counters = counters - mStartCounters;
+			mStartCounters = counters;
+		}
+		mReport.add(phase);
+		mStart = now;
+	}
+
+	// Start the next phase now without reporting the running one, which was reported some other way
+	void restart()
+	{
+		if (mCounters != nullptr)
+		{
+			mStartCounters = mCounters->read();
+		}
+		mStart = std::chrono::steady_clock::now();
+	}
+private:
+	TimingReport& mReport;
+	PerformanceCounters* mCounters;
+	std::chrono::steady_clock::time_point mStart;
+	CounterValues mStartCounters;
+};
@@ -0,0 +1,1271 @@
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <tuple>
+
+#include "BenchmarkReport.h"
+#include "BinaryDataFile.h"
+#include "DataContainer.h"
+#include "FenwickTree2D.h"
+#include "InputParser.h"
+#include "PerformanceCounters.h"
+#include "SummedAreaTableBatchGenerator.h"
+#include "SummedAreaTableGenerator.h"
+#include "SummedAreaTableGeneratorCached.h"
+#include "SummedAreaTableGeneratorFactory.h"
+#include "SummedAreaTableGeneratorCpuMultiChannelImpl.h"
+#include "SummedAreaTableGeneratorCpuTiledImpl.h"
+#include "SummedAreaTableOutOfCoreGenerator.h"
+#include "SummedAreaTableQuery.h"
+#include "SummedAreaTableStatisticsGenerator.h"
+#include "SummedAreaTableStatisticsQuery.h"
+#include "SummedAreaTableUpdater.h"
+#include "SummedVolumeTableGenerator.h"
+#include "SummedVolumeTableQuery.h"
+#include "SummedVolumeTableStreamGenerator.h"
+#include "SyntheticInput.h"
+#include "constants.h"
+
+// Benchmark for the CPU summed area table generators. Doesn't need DirectX, so it
+// can be used to compare the CPU implementations on any machine.
+
+static const std::string DEFAULT_BENCHMARK_DATA_DIRECTORY = "data";
+static const int DEFAULT_BENCHMARK_REPETITIONS = 5;
+static const int DEFAULT_BENCHMARK_WARMUP = 1;
+static const std::vector<int> DEFAULT_BENCHMARK_SIZES = { 4096, 8192 };
+static const std::vector<int> BENCHMARK_DATA_NUM_OF_BITS = { 8, 16, 32 };
+static const int DEFAULT_BENCHMARK_QUERY_COUNT = 1000000;
+static const int BENCHMARK_QUERY_MAX_SIZE = 64;
+static const int BENCHMARK_FENWICK_OPERATION_COUNT = 100000;
+static const size_t BENCHMARK_OUT_OF_CORE_BUDGET = 16 * 1024 * 1024;
+static const int BENCHMARK_BATCH_SMALL_FRAME_COUNT = 1024;
+static const int BENCHMARK_BATCH_SMALL_FRAME_SIZE = 128;
+static const int BENCHMARK_BATCH_LARGE_FRAME_COUNT = 4;
+static const int BENCHMARK_BATCH_LARGE_FRAME_SIZE = 2048;
+static const int BENCHMARK_MULTI_CHANNEL_SIZE = 2048;
+static const int BENCHMARK_VOLUME_SIZE = 256;
+static const int BENCHMARK_VOLUME_DEPTH = 128;
+static const int BENCHMARK_REFERENCE_VOLUME_WIDTH = 13;
+static const int BENCHMARK_REFERENCE_VOLUME_HEIGHT = 7;
+static const int BENCHMARK_REFERENCE_VOLUME_DEPTH = 5;
+static const int BENCHMARK_REFERENCE_QUERY_COUNT = 1000;
+static const int BENCHMARK_REFERENCE_IMAGE_WIDTH = 29;
+static const int BENCHMARK_REFERENCE_IMAGE_HEIGHT = 17;
+static const int BENCHMARK_STATISTICS_FRAME_COUNT = 256;
+static const int BENCHMARK_STATISTICS_FRAME_SIZE = 256;
+
+struct BenchmarkOptions
+{
+	std::string data_directory{DEFAULT_BENCHMARK_DATA_DIRECTORY};
+	int repetitions{DEFAULT_BENCHMARK_REPETITIONS};
+	int warmup{DEFAULT_BENCHMARK_WARMUP};
+	int query_count{DEFAULT_BENCHMARK_QUERY_COUNT};
+	// Sides of the square synthetic inputs
+	std::vector<int> sizes{DEFAULT_BENCHMARK_SIZES};
+	std::vector<SyntheticPattern> patterns{SyntheticPattern::Random};
+	std::vector<int> num_of_bits{BENCHMARK_DATA_NUM_OF_BITS};
+	// Only time the generators, skipping the query, update, cache, batch, multi-channel, volume, statistics and loading benchmarks
+	bool generators_only{false};
+	// Count hardware events of the generator phases with PerformanceCounters
+	bool performance_counters{false};
+	std::string json_file;
+	std::string csv_file;
+};
+
+template <typename T>
+struct BenchmarkInput
+{
+	std::string name;
+	DataContainer<T> data;
+};
+
+template <typename T>
+struct BenchmarkGenerator
+{
+	std::string name;
+	std::unique_ptr<SummedAreaTableGenerator<T>> generator;
+};
+
+// Run the generator warmup times without timing it, so the caches, page tables and thread pools are
+// warm, then the given number of times, and return the statistics of the total times of every phase in milliseconds
+// The mean phases of the timed runs go to mean_phases_out when it's given
+template <typename T>
+TimingStatistics measure_generator(SummedAreaTableGenerator<T>& generator, const DataContainer<T>& input, DataContainer<T>& output,
+	int warmup, int repetitions, TimingReport* mean_phases_out = nullptr)
+{
+	for (int i = 0; i < warmup; ++i)
+	{
+		generator.generate(input, output);
+	}
+
+	std::vector<float> times(repetitions);
+	TimingReport summed_phases;
+	for (float& time : times)
+	{
+		TimingReport timing = generator.generate(input, output);
+		time = timing.total_milliseconds();
+		summed_phases.add(timing);
+	}
+
+	if (mean_phases_out != nullptr)
+	{
+		*mean_phases_out = TimingReport();
+		for (TimingPhase phase : summed_phases.phases())
+		{
+			phase.nanoseconds /= repetitions;
+			phase.counters = { phase.counters.cycles / repetitions, phase.counters.instructions / repetitions,
+				phase.counters.llc_misses / repetitions, phase.counters.branch_misses / repetitions };
+			mean_phases_out->add(phase);
+		}
+	}
+	return compute_timing_statistics(times);
+}
+
+// Run the generator the given number of times and return the fastest time in milliseconds
+template <typename T>
+float run_benchmark(SummedAreaTableGenerator<T>& generator, const DataContainer<T>& input, DataContainer<T>& output, int repetitions)
+{
+	return measure_generator(generator, input, output, 0, repetitions).min;
+}
+
+// Run the function the given number of times and return the fastest time in milliseconds
+template <typename Function>
+float time_best_of(int repetitions, Function&& function)
+{
+	float best_time = 0.0f;
+	for (int i = 0; i < repetitions; ++i)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		function();
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		float time = TimingReport::to_milliseconds(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		best_time = i == 0 ? time : std::min(best_time, time);
+	}
+	return best_time;
+}
+
+// Random rectangles up to BENCHMARK_QUERY_MAX_SIZE wide and high, some of them crossing the borders
+std::vector<QueryRectangle> create_random_queries(int width, int height, int query_count)
+{
+	std::mt19937 random(0);
+	std::uniform_int_distribution<int> x_distribution(-BENCHMARK_QUERY_MAX_SIZE / 2, width - 1);
+	std::uniform_int_distribution<int> y_distribution(-BENCHMARK_QUERY_MAX_SIZE / 2, height - 1);
+	std::uniform_int_distribution<int> size_distribution(1, BENCHMARK_QUERY_MAX_SIZE);
+
+	std::vector<QueryRectangle> queries(query_count);
+	for (QueryRectangle& query : queries)
+	{
+		query.x = x_distribution(random);
+		query.y = y_distribution(random);
+		query.width = size_distribution(random);
+		query.height = size_distribution(random);
+	}
+	return queries;
+}
+
+// Benchmark box sum queries on a generated table: one query at a time, batched, and batched in locality order
+template <typename T>
+void run_query_benchmarks(const std::string& table_name, const DataContainer<T>& table, int query_count, int repetitions)
+{
+	std::vector<QueryRectangle> queries = create_random_queries(table.width, table.height, query_count);
+	SummedAreaTableQuery<T> query(table);
+
+	std::vector<T> reference_sums(queries.size());
+	float single_time = time_best_of(repetitions, [&]()
+	{
+		for (size_t i = 0; i < queries.size(); ++i)
+		{
+			reference_sums[i] = query.box_sum(queries[i]);
+		}
+	});
+
+	std::vector<T> batched_sums;
+	float batched_time = time_best_of(repetitions, [&]() { query.box_sums(queries, batched_sums); });
+	if (batched_sums != reference_sums)
+	{
+		throw std::runtime_error("Batched box sums don't match the single queries for " + table_name);
+	}
+
+	std::vector<T> sorted_sums;
+	float sorted_time = time_best_of(repetitions, [&]() { query.box_sums(queries, sorted_sums, true); });
+	if (sorted_sums != reference_sums)
+	{
+		throw std::runtime_error("Locality sorted box sums don't match the single queries for " + table_name);
+	}
+
+	std::cout << std::endl << queries.size() << " random box sum queries on " << table_name << ", batched with "
+		<< SummedAreaTableQuery<T>::batch_path_name() << std::endl;
+	std::cout << std::left << std::setw(28) << "Query" << std::right << std::setw(12) << "Time (ms)"
+		<< std::setw(14) << "Mquery/s" << std::setw(10) << "Speedup" << std::endl;
+
+	std::pair<std::string, float> results[] = { { "Single", single_time }, { "Batched", batched_time }, { "Batched locality sorted", sorted_time } };
+	for (const auto& [name, time] : results)
+	{
+		std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << time
+			<< std::setw(14) << queries.size() / (std::max(time, 0.001f) * 1000.0)
+			<< std::setw(9) << single_time / std::max(time, 0.001f) << "x" << std::endl;
+	}
+}
+
+// Benchmark incremental updates after small input changes in different parts of the image
+// against regenerating the whole table with the parallel generator
+template <typename T>
+void run_update_benchmarks(const std::string& input_name, const DataContainer<T>& input, const DataContainer<T>& table, int repetitions)
+{
+	static const int DIRTY_SIZE = 16;
+	int width = input.width;
+	int height = input.height;
+
+	auto full_generator = SummedAreaTableGeneratorFactory::create_cpu_generator<T>("parallel", CpuGeneratorSettings{});
+	auto reference_generator = SummedAreaTableGeneratorFactory::create_cpu_generator<T>("reference", CpuGeneratorSettings{});
+	DataContainer<T> full_output;
+	float full_time = run_benchmark(*full_generator, input, full_output, repetitions);
+
+	std::pair<std::string, std::vector<QueryRectangle>> scenarios[] = {
+		{ "Bottom right 16 x 16", { { width - DIRTY_SIZE, height - DIRTY_SIZE, DIRTY_SIZE, DIRTY_SIZE } } },
+		{ "Center 16 x 16", { { width / 2, height / 2, DIRTY_SIZE, DIRTY_SIZE } } },
+		{ "Top left 16 x 16", { { 0, 0, DIRTY_SIZE, DIRTY_SIZE } } },
+		{ "4 scattered 16 x 16", { { width / 4, height / 2, DIRTY_SIZE, DIRTY_SIZE }, { width / 2, height / 4, DIRTY_SIZE, DIRTY_SIZE },
+			{ 3 * width / 4, height / 2, DIRTY_SIZE, DIRTY_SIZE }, { width / 2, 3 * height / 4, DIRTY_SIZE, DIRTY_SIZE } } }
+	};
+
+	std::cout << std::endl << "Incremental updates on " << input_name << ", full parallel generation " << full_time << " ms" << std::endl;
+	std::cout << std::left << std::setw(28) << "Dirty region" << std::right << std::setw(12) << "Time (ms)"
+		<< std::setw(14) << "Updated (%)" << std::setw(12) << "Speedup" << std::endl;
+
+	SummedAreaTableUpdater<T> updater;
+	for (const auto& [name, dirty_rectangles] : scenarios)
+	{
+		DataContainer<T> changed_input = input;
+		for (const QueryRectangle& rectangle : dirty_rectangles)
+		{
+			for (int y = std::max(rectangle.y, 0); y < std::min(rectangle.y + rectangle.height, height); ++y)
+			{
+				for (int x = std::max(rectangle.x, 0); x < std::min(rectangle.x + rectangle.width, width); ++x)
+				{
+					++changed_input.data[static_cast<size_t>(y) * width + x];
+				}
+			}
+		}
+
+		// Updating twice with the same input gives the same table, so the repetitions can reuse it
+		DataContainer<T> updated_table = table;
+		UpdateStatistics statistics = updater.update(changed_input, updated_table, dirty_rectangles);
+		float time = statistics.timing.total_milliseconds();
+		for (int i = 1; i < repetitions; ++i)
+		{
+			time = std::min(time, updater.update(changed_input, updated_table, dirty_rectangles).timing.total_milliseconds());
+		}
+
+		DataContainer<T> reference_table;
+		reference_generator->generate(changed_input, reference_table);
+		if (updated_table.data != reference_table.data)
+		{
+			throw std::runtime_error("Incremental update doesn't match the reference for " + name + " on " + input_name);
+		}
+
+		std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << time
+			<< std::setw(14) << 100.0 * (1.0 - statistics.saved_fraction())
+			<< std::setw(11) << full_time / std::max(time, 0.001f) << "x" << std::endl;
+	}
+}
+
+// Benchmark point updates and box queries on a Fenwick tree against regenerating the summed area
+// table after every update, and print the number of queries per update below which the tree wins
+template <typename T>
+void run_fenwick_benchmarks(const std::vector<BenchmarkInput<T>>& inputs, int repetitions)
+{
+	std::cout << std::endl << "Fenwick tree against summed area table regeneration with the SIMD generator" << std::endl;
+	std::cout << std::left << std::setw(28) << "Input" << std::right << std::setw(12) << "Build (ms)"
+		<< std::setw(14) << "Update (ns)" << std::setw(14) << "Query (ns)" << std::setw(16) << "SAT query (ns)"
+		<< std::setw(16) << "Regenerate (ms)" << std::setw(20) << "Break-even q/u" << std::endl;
+
+	CpuGeneratorSettings wrap_settings;
+	wrap_settings.overflow_mode = OverflowMode::Wrap;
+	auto generator = SummedAreaTableGeneratorFactory::create_cpu_generator<T>("simd", wrap_settings);
+
+	for (const BenchmarkInput<T>& input : inputs)
+	{
+		const DataContainer<T>& data = input.data;
+		std::vector<QueryRectangle> queries = create_random_queries(data.width, data.height, BENCHMARK_FENWICK_OPERATION_COUNT);
+		std::vector<QueryRectangle> updates = create_random_queries(data.width, data.height, BENCHMARK_FENWICK_OPERATION_COUNT);
+		for (QueryRectangle& update : updates)
+		{
+			update.x = std::clamp(update.x, 0, data.width - 1);
+			update.y = std::clamp(update.y, 0, data.height - 1);
+		}
+
+		DataContainer<T> table;
+		float regenerate_time = run_benchmark(*generator, data, table, repetitions);
+		SummedAreaTableQuery<T> table_query(table);
+
+		FenwickTree2D<T> tree;
+		float build_time = time_best_of(repetitions, [&]() { tree.build(data); });
+
+		// Every query of the tree and the wraparound table has to agree modulo 2^bits
+		uint64_t checksum = 0;
+		float query_time = time_best_of(repetitions, [&]()
+		{
+			for (const QueryRectangle& query : queries)
+			{
+				checksum += static_cast<T>(tree.box_sum(query));
+			}
+		});
+		float table_query_time = time_best_of(repetitions, [&]()
+		{
+			for (const QueryRectangle& query : queries)
+			{
+				checksum -= table_query.box_sum(query);
+			}
+		});
+		if (checksum != 0)
+		{
+			throw std::runtime_error("Fenwick tree box sums don't match the summed area table for " + input.name);
+		}
+
+		// Alternate +1 and -1, so the tree stays the same over the repetitions
+		int64_t delta = 1;
+		float update_time = time_best_of(repetitions, [&]()
+		{
+			for (const QueryRectangle& update : updates)
+			{
+				tree.add(update.x, update.y, delta);
+			}
+			delta = -delta;
+		});
+
+		double update_nanoseconds = update_time * 1.0e6 / updates.size();
+		double query_nanoseconds = query_time * 1.0e6 / queries.size();
+		double table_query_nanoseconds = table_query_time * 1.0e6 / queries.size();
+
+		// Per update the table costs a regeneration plus r cheap queries, the tree an update plus r
+		// slower queries. Both are equal at r = (regenerate - update) / (query - table query)
+		double break_even = (regenerate_time * 1.0e6 - update_nanoseconds) / std::max(query_nanoseconds - table_query_nanoseconds, 0.001);
+
+		std::cout << std::left << std::setw(28) << input.name << std::right << std::setw(12) << build_time
+			<< std::setw(14) << update_nanoseconds << std::setw(14) << query_nanoseconds << std::setw(16) << table_query_nanoseconds
+			<< std::setw(16) << regenerate_time << std::setw(20) << break_even << std::endl;
+	}
+	std::cout << "The Fenwick tree is faster while there are fewer queries per update than the break-even ratio" << std::endl;
+}
+
+// Benchmark the out-of-core generator on binary data files of the input in the temporary directory,
+// with a memory budget much smaller than the input and output
+template <typename T>
+void run_out_of_core_benchmark(const std::string& input_name, const DataContainer<T>& input, const DataContainer<T>& reference_table, int repetitions)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path();
+	std::string input_file = (directory / "summed_area_table_benchmark_out_of_core_input.satb").string();
+	std::string output_file = (directory / "summed_area_table_benchmark_out_of_core_table.satb").string();
+	size_t table_bytes = input.data.size() * sizeof(T);
+
+	BinaryDataFile::write(input_file, input, BinaryPayload::Input);
+
+	SummedAreaTableOutOfCoreGenerator<T> generator(BENCHMARK_OUT_OF_CORE_BUDGET);
+	// Keep the phases of the fastest run
+	TimingReport timing = generator.generate(input_file, output_file);
+	for (int i = 1; i < repetitions; ++i)
+	{
+		TimingReport run_timing = generator.generate(input_file, output_file);
+		if (run_timing.total() < timing.total())
+		{
+			timing = run_timing;
+		}
+	}
+	float time = timing.total_milliseconds();
+
+	DataContainer<T> output;
+	bool valid_reader = true;
+	{
+		MappedDataView<T> view(output_file);
+		if (view.payload() == BinaryPayload::SummedAreaTable)
+		{
+			view.copy_to(output);
+		}
+
+		// Read back a few values through the windows of the file reader
+		SummedAreaTableFileReader<T> reader(output_file, input.width, input.height);
+		std::mt19937 random(1);
+		for (int i = 0; i < 64 && !input.data.empty(); ++i)
+		{
+			int x = std::uniform_int_distribution<int>(0, input.width - 1)(random);
+			int y = std::uniform_int_distribution<int>(0, input.height - 1)(random);
+			valid_reader = valid_reader && reader.value(x, y) == reference_table.data[static_cast<size_t>(y) * input.width + x];
+		}
+	}
+	std::filesystem::remove(input_file);
+	std::filesystem::remove(output_file);
+
+	if (output.data != reference_table.data || !valid_reader)
+	{
+		throw std::runtime_error("Out-of-core output doesn't match the reference for " + input_name);
+	}
+
+	double pixel_count = static_cast<double>(input.width) * input.height;
+	std::cout << std::endl << "Out-of-core generation of " << input_name << " with a " << BENCHMARK_OUT_OF_CORE_BUDGET / (1024 * 1024)
+		<< " MB budget for " << 2 * table_bytes / (1024 * 1024) << " MB of input and output (bands of "
+		<< generator.band_height(input.width) << " rows): " << time << " ms, "
+		<< pixel_count / (std::max(time, 0.001f) * 1000.0) << " Mpixel/s" << std::endl;
+	std::cout << "Phases:";
+	for (const TimingPhase& phase : timing.phases())
+	{
+		std::cout << " " << phase.name << " " << TimingReport::to_milliseconds(phase.nanoseconds) << " ms";
+	}
+	std::cout << std::endl;
+}
+
+// Compare loading a data file as text with loading it as binary data files, copied into a container
+// and mapped in place
+template <typename T>
+void run_load_benchmark(const std::string& input_file, const std::string& input_name, const DataContainer<T>& reference_table, int repetitions)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path();
+	std::string binary_input_file = (directory / "summed_area_table_benchmark_input.satb").string();
+	std::string binary_table_file = (directory / "summed_area_table_benchmark_table.satb").string();
+
+	DataContainer<T> text_input;
+	float text_time = time_best_of(repetitions, [&]()
+	{
+		InputParser::parse_input_file(input_file, text_input);
+	});
+	float parallel_text_time = time_best_of(repetitions, [&]()
+	{
+		InputParser::parse_input_file(input_file, text_input, 0);
+	});
+
+	BinaryDataFile::write(binary_input_file, text_input, BinaryPayload::Input);
+	DataContainer<T> binary_input;
+	float binary_time = time_best_of(repetitions, [&]()
+	{
+		InputParser::parse_input_file(binary_input_file, binary_input);
+	});
+
+	// Mapping the table and reading a box sum touches only the pages of the corners
+	BinaryDataFile::write(binary_table_file, reference_table, BinaryPayload::SummedAreaTable);
+	QueryRectangle whole_table{ 0, 0, reference_table.width, reference_table.height };
+	T mapped_sum = 0;
+	float mapped_time = time_best_of(repetitions, [&]()
+	{
+		MappedDataView<T> view(binary_table_file);
+		mapped_sum = SummedAreaTableQuery<T>(view.data(), view.width(), view.height(), view.row_stride()).box_sum(whole_table);
+	});
+
+	uint64_t text_bytes = std::filesystem::file_size(input_file);
+	uint64_t binary_bytes = std::filesystem::file_size(binary_input_file);
+	std::filesystem::remove(binary_input_file);
+	std::filesystem::remove(binary_table_file);
+
+	if (binary_input.data != text_input.data || mapped_sum != SummedAreaTableQuery<T>(reference_table).box_sum(whole_table))
+	{
+		throw std::runtime_error("Binary data files don't match the text input for " + input_name);
+	}
+
+	std::cout << std::endl << "Loading " << input_name << ": text (" << text_bytes / 1024 << " KB, " << InputParser::tokenizer_name()
+		<< " tokenizer) " << text_time << " ms, "
+		<< parallel_text_time << " ms on every hardware thread, binary (" << binary_bytes / 1024 << " KB) " << binary_time
+		<< " ms, mapped table with a box sum " << mapped_time << " ms" << std::endl;
+}
+
+// Compare generating a table on a cache miss, including storing it, with mapping it in on a hit
+template <typename T>
+void run_cache_benchmark(const std::string& input_name, const DataContainer<T>& input, const DataContainer<T>& reference_table, int repetitions)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "summed_area_table_benchmark_cache";
+	std::filesystem::remove_all(directory);
+
+	const std::string& reference_name = SummedAreaTableGeneratorFactory::cpu_generator_names().front();
+	SummedAreaTableCache cache(directory.string());
+	SummedAreaTableGeneratorCached<T> generator(SummedAreaTableGeneratorFactory::create_cpu_generator<T>(reference_name, CpuGeneratorSettings{}), reference_name, cache);
+
+	DataContainer<T> output;
+	float miss_time = generator.generate(input, output).total_milliseconds();
+	float hit_time = run_benchmark(generator, input, output, repetitions);
+	std::filesystem::remove_all(directory);
+
+	if (output.data != reference_table.data || cache.statistics().hits != static_cast<uint64_t>(repetitions))
+	{
+		throw std::runtime_error("Cached output doesn't match the reference for " + input_name);
+	}
+
+	std::cout << std::endl << "Cache of " << input_name << ": miss " << miss_time << " ms (generate and store), hit "
+		<< hit_time << " ms (hash and map)" << std::endl;
+}
+
+// Compare generating a batch of many small frames and a few large ones one at a time with the
+// batch generator, which runs the small frames side by side and splits the large ones
+template <typename T>
+void run_batch_benchmark(int repetitions)
+{
+	std::vector<DataContainer<T>> frames;
+	std::pair<int, int> frame_sizes[] = { { BENCHMARK_BATCH_SMALL_FRAME_COUNT, BENCHMARK_BATCH_SMALL_FRAME_SIZE },
+		{ BENCHMARK_BATCH_LARGE_FRAME_COUNT, BENCHMARK_BATCH_LARGE_FRAME_SIZE } };
+	for (const auto& [count, size] : frame_sizes)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			DataContainer<T> frame;
+			SyntheticInput::generate(SyntheticInputSettings{ SyntheticPattern::Random, size, size, static_cast<uint64_t>(frames.size()) }, frame, 0);
+			frames.push_back(std::move(frame));
+		}
+	}
+
+	std::vector<DataContainer<T>> reference_outputs(frames.size());
+	auto run_one_at_a_time = [&](const std::string& name)
+	{
+		auto generator = SummedAreaTableGeneratorFactory::create_cpu_generator<T>(name, CpuGeneratorSettings{});
+		return time_best_of(repetitions, [&]()
+		{
+			for (size_t i = 0; i < frames.size(); ++i)
+			{
+				generator->generate(frames[i], reference_outputs[i]);
+			}
+		});
+	};
+	float parallel_time = run_one_at_a_time("parallel");
+	float simd_time = run_one_at_a_time("simd");
+
+	SummedAreaTableBatchGenerator<T> batch_generator;
+	std::vector<DataContainer<T>> batch_outputs(frames.size());
+	BatchReport batch_report = batch_generator.generate(frames, batch_outputs);
+	for (int i = 1; i < repetitions; ++i)
+	{
+		BatchReport repeated_report = batch_generator.generate(frames, batch_outputs);
+		if (repeated_report.timing.total() < batch_report.timing.total())
+		{
+			batch_report = repeated_report;
+		}
+	}
+
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		if (batch_outputs[i].data != reference_outputs[i].data)
+		{
+			throw std::runtime_error("Batch output doesn't match the SIMD generator for frame " + std::to_string(i));
+		}
+	}
+
+	double pixel_count = static_cast<double>(batch_report.element_count);
+	std::cout << std::endl << "Batch of " << BENCHMARK_BATCH_SMALL_FRAME_COUNT << " frames of " << BENCHMARK_BATCH_SMALL_FRAME_SIZE << " x "
+		<< BENCHMARK_BATCH_SMALL_FRAME_SIZE << " and " << BENCHMARK_BATCH_LARGE_FRAME_COUNT << " of " << BENCHMARK_BATCH_LARGE_FRAME_SIZE << " x "
+		<< BENCHMARK_BATCH_LARGE_FRAME_SIZE << ", " << batch_generator.thread_count() << " batch threads" << std::endl;
+	std::cout << std::left << std::setw(28) << "Generation" << std::right << std::setw(12) << "Time (ms)"
+		<< std::setw(12) << "Mpixel/s" << std::setw(12) << "Frames/s" << std::setw(10) << "Speedup" << std::endl;
+
+	std::pair<std::string, float> results[] = { { "One at a time, CPU SIMD", simd_time }, { "One at a time, CPU Parallel", parallel_time },
+		{ "Batch", batch_report.timing.total_milliseconds() } };
+	for (const auto& [name, time] : results)
+	{
+		std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << time
+			<< std::setw(12) << pixel_count / (std::max(time, 0.001f) * 1000.0)
+			<< std::setw(12) << frames.size() / (std::max(time, 0.001f) / 1000.0)
+			<< std::setw(9) << simd_time / std::max(time, 0.001f) << "x" << std::endl;
+	}
+}
+
+// Compare generating the tables of RGB and RGBA images by de-interleaving them and running the SIMD
+// generator per channel with the multi-channel generator, which sums every channel in one pass
+template <typename T>
+void run_multi_channel_benchmark(int repetitions)
+{
+	std::cout << std::endl << "Multi-channel " << BENCHMARK_MULTI_CHANNEL_SIZE << " x " << BENCHMARK_MULTI_CHANNEL_SIZE << " images" << std::endl;
+	std::cout << std::left << std::setw(28) << "Channels" << std::setw(28) << "Generation" << std::right << std::setw(12) << "Time (ms)"
+		<< std::setw(12) << "Mpixel/s" << std::setw(10) << "Speedup" << std::endl;
+
+	for (int channels : { 3, 4 })
+	{
+		DataContainer<T> image;
+		SyntheticInput::generate(SyntheticInputSettings{ SyntheticPattern::Random, BENCHMARK_MULTI_CHANNEL_SIZE * channels, BENCHMARK_MULTI_CHANNEL_SIZE }, image, 0);
+		image.width = BENCHMARK_MULTI_CHANNEL_SIZE;
+		image.channels = channels;
+		size_t pixel_count = static_cast<size_t>(image.width) * image.height;
+
+		auto generator = SummedAreaTableGeneratorFactory::create_cpu_generator<T>("simd", CpuGeneratorSettings{});
+		std::vector<DataContainer<T>> planes(channels);
+		std::vector<DataContainer<T>> plane_tables(channels);
+		float separate_time = time_best_of(repetitions, [&]()
+		{
+			for (int channel = 0; channel < channels; ++channel)
+			{
+				DataContainer<T>& plane = planes[channel];
+				plane.width = image.width;
+				plane.height = image.height;
+				plane.data.resize(pixel_count);
+				for (size_t i = 0; i < pixel_count; ++i)
+				{
+					plane.data[i] = image.data[i * channels + channel];
+				}
+				generator->generate(plane, plane_tables[channel]);
+			}
+		});
+
+		SummedAreaTableGeneratorCpuMultiChannelImpl<T> multi_channel_generator;
+		DataContainer<T> interleaved_table;
+		float interleaved_time = run_benchmark(multi_channel_generator, image, interleaved_table, repetitions);
+		multi_channel_generator.set_output_layout(ChannelLayout::Planar);
+		DataContainer<T> planar_table;
+		float planar_time = run_benchmark(multi_channel_generator, image, planar_table, repetitions);
+
+		for (int channel = 0; channel < channels; ++channel)
+		{
+			for (size_t i = 0; i < pixel_count; ++i)
+			{
+				T expected = plane_tables[channel].data[i];
+				if (interleaved_table.data[i * channels + channel] != expected || planar_table.data[channel * pixel_count + i] != expected)
+				{
+					throw std::runtime_error("Multi-channel output doesn't match the SIMD generator for channel " + std::to_string(channel));
+				}
+			}
+		}
+
+		std::pair<std::string, float> results[] = { { "De-interleave, CPU SIMD", separate_time }, { "Multi-channel interleaved", interleaved_time },
+			{ "Multi-channel planar", planar_time } };
+		for (const auto& [name, time] : results)
+		{
+			std::cout << std::left << std::setw(28) << (channels == 3 ? "RGB" : "RGBA") << std::setw(28) << name << std::right << std::setw(12) << time
+				<< std::setw(12) << pixel_count / (std::max(time, 0.001f) * 1000.0)
+				<< std::setw(9) << separate_time / std::max(time, 0.001f) << "x" << std::endl;
+		}
+	}
+}
+
+// Check the summed volume tables of a small random volume and cuboid sums against them with
+// brute force sums of the input, in both overflow modes
+template <typename T>
+void check_volume_reference()
+{
+	const int width = BENCHMARK_REFERENCE_VOLUME_WIDTH;
+	const int height = BENCHMARK_REFERENCE_VOLUME_HEIGHT;
+	const int depth = BENCHMARK_REFERENCE_VOLUME_DEPTH;
+	auto index = [&](int x, int y, int z) { return (static_cast<size_t>(z) * height + y) * width + x; };
+
+	std::mt19937 random(0);
+	for (OverflowMode mode : { OverflowMode::Wrap, OverflowMode::Saturate })
+	{
+		// Smaller values for saturation only clamp the far part of the table, so some cuboid sums stay exact
+		uint64_t max_value = mode == OverflowMode::Wrap ? DATA_MAX_VALUE<T> : DATA_MAX_VALUE<T> / 64;
+		std::uniform_int_distribution<uint64_t> value_distribution(0, max_value);
+		VolumeContainer<T> volume{ width, height, depth, std::vector<T>(static_cast<size_t>(width) * height * depth) };
+		for (T& value : volume.data)
+		{
+			value = static_cast<T>(value_distribution(random));
+		}
+
+		// Sum of the input in the cuboid [x_begin, x_end) x [y_begin, y_end) x [z_begin, z_end)
+		auto brute_force_sum = [&](int x_begin, int x_end, int y_begin, int y_end, int z_begin, int z_end)
+		{
+			uint64_t sum = 0;
+			for (int z = z_begin; z < z_end; ++z)
+			{
+				for (int y = y_begin; y < y_end; ++y)
+				{
+					for (int x = x_begin; x < x_end; ++x)
+					{
+						sum += volume.data[index(x, y, z)];
+					}
+				}
+			}
+			return sum;
+		};
+
+		VolumeContainer<T> table;
+		SummedVolumeTableGenerator<T> single_thread_generator(1);
+		single_thread_generator.set_overflow_mode(mode);
+		single_thread_generator.generate(volume, table);
+		VolumeContainer<T> parallel_table;
+		SummedVolumeTableGenerator<T> generator;
+		generator.set_overflow_mode(mode);
+		generator.generate(volume, parallel_table);
+		std::vector<T> stream_table(volume.data.size());
+		SummedVolumeTableStreamGenerator<T> stream_generator;
+		stream_generator.set_overflow_mode(mode);
+		stream_generator.reset(width, height);
+		for (int z = 0; z < depth; ++z)
+		{
+			stream_generator.generate_slice(volume.data.data() + index(0, 0, z), stream_table.data() + index(0, 0, z));
+		}
+
+		// Clamping every partial sum of nonnegative values gives the same as clamping the true sum once
+		std::vector<uint64_t> prefix_sums(volume.data.size());
+		for (int z = 0; z < depth; ++z)
+		{
+			for (int y = 0; y < height; ++y)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					size_t i = index(x, y, z);
+					prefix_sums[i] = brute_force_sum(0, x + 1, 0, y + 1, 0, z + 1);
+					T expected = static_cast<T>(mode == OverflowMode::Wrap ? prefix_sums[i] : std::min(prefix_sums[i], DATA_MAX_VALUE<T>));
+					if (table.data[i] != expected || parallel_table.data[i] != expected || stream_table[i] != expected)
+					{
+						throw std::runtime_error("Summed volume table doesn't match the brute force sums in " + overflow_mode_name(mode)
+							+ " mode at (" + std::to_string(x) + ", " + std::to_string(y) + ", " + std::to_string(z) + ")");
+					}
+				}
+			}
+		}
+
+		// Cuboids partly outside the table and empty ones included
+		SummedVolumeTableQuery<T> query(table);
+		for (int i = 0; i < BENCHMARK_REFERENCE_QUERY_COUNT; ++i)
+		{
+			QueryCuboid cuboid{ std::uniform_int_distribution<int>(-2, width)(random), std::uniform_int_distribution<int>(-2, height)(random),
+				std::uniform_int_distribution<int>(-2, depth)(random), std::uniform_int_distribution<int>(0, width + 2)(random),
+				std::uniform_int_distribution<int>(0, height + 2)(random), std::uniform_int_distribution<int>(0, depth + 2)(random) };
+			int x_begin = std::max(cuboid.x, 0);
+			int y_begin = std::max(cuboid.y, 0);
+			int z_begin = std::max(cuboid.z, 0);
+			int x_end = std::min(cuboid.x + cuboid.width, width);
+			int y_end = std::min(cuboid.y + cuboid.height, height);
+			int z_end = std::min(cuboid.z + cuboid.depth, depth);
+			bool empty = x_begin >= x_end || y_begin >= y_end || z_begin >= z_end;
+
+			// A saturated table only gives exact sums while the far corner isn't clamped
+			if (!empty && mode == OverflowMode::Saturate && prefix_sums[index(x_end - 1, y_end - 1, z_end - 1)] > DATA_MAX_VALUE<T>)
+			{
+				continue;
+			}
+			T expected = empty ? 0 : static_cast<T>(brute_force_sum(x_begin, x_end, y_begin, y_end, z_begin, z_end));
+			if (query.cuboid_sum(cuboid) != expected)
+			{
+				throw std::runtime_error("Cuboid sum doesn't match the brute force sum in " + overflow_mode_name(mode) + " mode");
+			}
+		}
+	}
+}
+
+// Benchmark generating a summed volume table on one and every hardware thread and by streaming it
+// slice by slice, and random cuboid sum queries against it
+template <typename T>
+void run_volume_benchmark(int query_count, int repetitions)
+{
+	check_volume_reference<T>();
+
+	VolumeContainer<T> volume;
+	DataContainer<T> slices;
+	SyntheticInput::generate(SyntheticInputSettings{ SyntheticPattern::Random, BENCHMARK_VOLUME_SIZE, BENCHMARK_VOLUME_SIZE * BENCHMARK_VOLUME_DEPTH }, slices, 0);
+	volume.width = BENCHMARK_VOLUME_SIZE;
+	volume.height = BENCHMARK_VOLUME_SIZE;
+	volume.depth = BENCHMARK_VOLUME_DEPTH;
+	volume.data = std::move(slices.data);
+	size_t slice_size = static_cast<size_t>(volume.width) * volume.height;
+
+	VolumeContainer<T> table;
+	SummedVolumeTableGenerator<T> single_thread_generator(1);
+	float single_thread_time = time_best_of(repetitions, [&]() { single_thread_generator.generate(volume, table); });
+	SummedVolumeTableGenerator<T> generator;
+	VolumeContainer<T> parallel_table;
+	float parallel_time = time_best_of(repetitions, [&]() { generator.generate(volume, parallel_table); });
+
+	SummedVolumeTableStreamGenerator<T> stream_generator;
+	std::vector<T> stream_slice(slice_size);
+	bool stream_matches = true;
+	float stream_time = time_best_of(repetitions, [&]()
+	{
+		stream_generator.reset(volume.width, volume.height);
+		for (int z = 0; z < volume.depth; ++z)
+		{
+			stream_generator.generate_slice(volume.data.data() + z * slice_size, stream_slice.data());
+			stream_matches = stream_matches && std::equal(stream_slice.begin(), stream_slice.end(), table.data.begin() + z * slice_size);
+		}
+	});
+
+	if (parallel_table.data != table.data || !stream_matches)
+	{
+		throw std::runtime_error("Summed volume tables don't match");
+	}
+
+	std::mt19937 random(0);
+	std::uniform_int_distribution<int> position_distribution(-BENCHMARK_QUERY_MAX_SIZE / 2, BENCHMARK_VOLUME_SIZE - 1);
+	std::uniform_int_distribution<int> size_distribution(1, BENCHMARK_QUERY_MAX_SIZE);
+	std::vector<QueryCuboid> cuboids(query_count);
+	for (QueryCuboid& cuboid : cuboids)
+	{
+		cuboid = { position_distribution(random), position_distribution(random), position_distribution(random) % BENCHMARK_VOLUME_DEPTH,
+			size_distribution(random), size_distribution(random), size_distribution(random) };
+	}
+	SummedVolumeTableQuery<T> query(table);
+	T checksum = 0;
+	float query_time = time_best_of(repetitions, [&]()
+	{
+		for (const QueryCuboid& cuboid : cuboids)
+		{
+			checksum += query.cuboid_sum(cuboid);
+		}
+	});
+
+	double voxel_count = static_cast<double>(volume.data.size());
+	std::cout << std::endl << "Summed volume table of " << volume.width << " x " << volume.height << " x " << volume.depth << std::endl;
+	std::cout << std::left << std::setw(28) << "Generation" << std::right << std::setw(12) << "Time (ms)"
+		<< std::setw(12) << "Mvoxel/s" << std::setw(10) << "Speedup" << std::endl;
+	std::pair<std::string, float> results[] = { { "One thread", single_thread_time }, { "Every hardware thread", parallel_time },
+		{ "Streamed slices", stream_time } };
+	for (const auto& [name, time] : results)
+	{
+		std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << time
+			<< std::setw(12) << voxel_count / (std::max(time, 0.001f) * 1000.0)
+			<< std::setw(9) << single_thread_time / std::max(time, 0.001f) << "x" << std::endl;
+	}
+	std::cout << cuboids.size() << " random cuboid sums: " << query_time << " ms, "
+		<< cuboids.size() / (std::max(query_time, 0.001f) * 1000.0) << " Mquery/s (checksum " << static_cast<uint64_t>(checksum) << ")" << std::endl;
+}
+
+// Check the statistics of random rectangles of a small random image, from the tables of the scalar
+// and SIMD kernels, against brute force sums and a two-pass mean and variance of the input
+template <typename T>
+void check_statistics_reference()
+{
+	const int width = BENCHMARK_REFERENCE_IMAGE_WIDTH;
+	const int height = BENCHMARK_REFERENCE_IMAGE_HEIGHT;
+	std::mt19937 random(0);
+	std::uniform_int_distribution<uint64_t> value_distribution(0, DATA_MAX_VALUE<T>);
+	DataContainer<T> image;
+	image.width = width;
+	image.height = height;
+	image.data.resize(static_cast<size_t>(width) * height);
+	for (T& value : image.data)
+	{
+		value = static_cast<T>(value_distribution(random));
+	}
+
+	for (bool use_simd : { false, true })
+	{
+		StatisticsTables tables;
+		SummedAreaTableStatisticsGenerator<T> generator(use_simd);
+		generator.generate(image, tables);
+		SummedAreaTableStatisticsQuery query(tables);
+
+		// Rectangles partly outside the image and empty ones included
+		std::vector<QueryRectangle> rectangles(BENCHMARK_REFERENCE_QUERY_COUNT);
+		for (QueryRectangle& rectangle : rectangles)
+		{
+			rectangle = { std::uniform_int_distribution<int>(-2, width)(random), std::uniform_int_distribution<int>(-2, height)(random),
+				std::uniform_int_distribution<int>(0, width + 2)(random), std::uniform_int_distribution<int>(0, height + 2)(random) };
+		}
+		std::vector<RegionStatistics> results;
+		query.statistics(rectangles, results);
+
+		for (size_t i = 0; i < rectangles.size(); ++i)
+		{
+			const QueryRectangle& rectangle = rectangles[i];
+			int x_begin = std::max(rectangle.x, 0);
+			int y_begin = std::max(rectangle.y, 0);
+			int x_end = std::min(rectangle.x + rectangle.width, width);
+			int y_end = std::min(rectangle.y + rectangle.height, height);
+
+			auto for_each_value = [&](auto&& function)
+			{
+				for (int y = y_begin; y < y_end; ++y)
+				{
+					for (int x = x_begin; x < x_end; ++x)
+					{
+						function(static_cast<uint64_t>(image.data[static_cast<size_t>(y) * width + x]));
+					}
+				}
+			};
+
+			// The 64 bit tables wrap around like these sums, but the variance is only exact while the squared sum fits
+			RegionStatistics expected;
+			bool exact_variance = true;
+			for_each_value([&](uint64_t value)
+			{
+				++expected.count;
+				expected.sum += value;
+				exact_variance = exact_variance && value * value <= UINT64_MAX - expected.squared_sum;
+				expected.squared_sum += value * value;
+			});
+			if (expected.count > 0)
+			{
+				expected.mean = static_cast<double>(expected.sum) / expected.count;
+				double squared_deviations = 0.0;
+				for_each_value([&](uint64_t value) { squared_deviations += (value - expected.mean) * (value - expected.mean); });
+				expected.variance = squared_deviations / expected.count;
+			}
+
+			// The query's variance cancels the mean of the squares, so its rounding error scales with that
+			const RegionStatistics& result = results[i];
+			RegionStatistics single_result = query.statistics(rectangle);
+			double tolerance = expected.count > 0 ? 1.0e-12 * static_cast<double>(expected.squared_sum) / expected.count + 1.0e-9 : 0.0;
+			if (result.count != expected.count || result.sum != expected.sum || result.squared_sum != expected.squared_sum
+				|| std::abs(result.mean - expected.mean) > 1.0e-9 * std::max(expected.mean, 1.0) || (exact_variance && std::abs(result.variance - expected.variance) > tolerance)
+				|| single_result.sum != result.sum || single_result.squared_sum != result.squared_sum || single_result.variance != result.variance)
+			{
+				throw std::runtime_error(std::string("Statistics of the ") + (use_simd ? "SIMD" : "scalar")
+					+ " tables don't match the brute force statistics for rectangle " + std::to_string(i));
+			}
+		}
+	}
+}
+
+// Benchmark generating the sum and squared sum tables with the scalar and SIMD kernels and in a batch,
+// and mean and variance queries against them
+template <typename T>
+void run_statistics_benchmark(const std::string& input_name, const DataContainer<T>& input, int query_count, int repetitions)
+{
+	check_statistics_reference<T>();
+
+	StatisticsTables scalar_tables;
+	SummedAreaTableStatisticsGenerator<T> scalar_generator(false);
+	float scalar_time = time_best_of(repetitions, [&]() { scalar_generator.generate(input, scalar_tables); });
+	StatisticsTables tables;
+	SummedAreaTableStatisticsGenerator<T> generator;
+	float simd_time = time_best_of(repetitions, [&]() { generator.generate(input, tables); });
+	if (tables.sums != scalar_tables.sums || tables.squared_sums != scalar_tables.squared_sums)
+	{
+		throw std::runtime_error("SIMD sum and squared sum tables don't match the scalar ones for " + input_name);
+	}
+
+	std::vector<DataContainer<T>> frames(BENCHMARK_STATISTICS_FRAME_COUNT);
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		SyntheticInput::generate(SyntheticInputSettings{ SyntheticPattern::Random, BENCHMARK_STATISTICS_FRAME_SIZE, BENCHMARK_STATISTICS_FRAME_SIZE, i }, frames[i], 0);
+	}
+	std::vector<StatisticsTables> frame_tables(frames.size());
+	float frames_time = time_best_of(repetitions, [&]()
+	{
+		for (size_t i = 0; i < frames.size(); ++i)
+		{
+			generator.generate(frames[i], frame_tables[i]);
+		}
+	});
+	SummedAreaTableBatchGenerator<T> batch_generator;
+	std::vector<StatisticsTables> batch_tables(frames.size());
+	float batch_time = time_best_of(repetitions, [&]() { batch_generator.generate_statistics(frames, batch_tables); });
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		if (batch_tables[i].sums != frame_tables[i].sums || batch_tables[i].squared_sums != frame_tables[i].squared_sums)
+		{
+			throw std::runtime_error("Batched sum and squared sum tables don't match for frame " + std::to_string(i));
+		}
+	}
+
+	std::vector<QueryRectangle> queries = create_random_queries(input.width, input.height, query_count);
+	std::vector<RegionStatistics> results;
+	SummedAreaTableStatisticsQuery query(tables);
+	float query_time = time_best_of(repetitions, [&]() { query.statistics(queries, results); });
+
+	double pixel_count = static_cast<double>(input.data.size());
+	double frame_pixel_count = static_cast<double>(frames.size()) * BENCHMARK_STATISTICS_FRAME_SIZE * BENCHMARK_STATISTICS_FRAME_SIZE;
+	std::cout << std::endl << "Sum and squared sum tables" << std::endl;
+	std::cout << std::left << std::setw(52) << "Generation" << std::right << std::setw(12) << "Time (ms)"
+		<< std::setw(12) << "Mpixel/s" << std::setw(10) << "Speedup" << std::endl;
+	std::string frames_name = std::to_string(frames.size()) + " frames of " + std::to_string(BENCHMARK_STATISTICS_FRAME_SIZE)
+		+ " x " + std::to_string(BENCHMARK_STATISTICS_FRAME_SIZE);
+	std::tuple<std::string, float, double, float> results_table[] = {
+		{ input_name + ", scalar", scalar_time, pixel_count, scalar_time },
+		{ input_name + ", SIMD", simd_time, pixel_count, scalar_time },
+		{ frames_name + ", SIMD one at a time", frames_time, frame_pixel_count, frames_time },
+		{ frames_name + ", SIMD batch", batch_time, frame_pixel_count, frames_time } };
+	for (const auto& [name, time, pixels, baseline_time] : results_table)
+	{
+		std::cout << std::left << std::setw(52) << name << std::right << std::setw(12) << time
+			<< std::setw(12) << pixels / (std::max(time, 0.001f) * 1000.0)
+			<< std::setw(9) << baseline_time / std::max(time, 0.001f) << "x" << std::endl;
+	}
+	std::cout << queries.size() << " random mean and variance queries on " << input_name << ": " << query_time << " ms, "
+		<< queries.size() / (std::max(query_time, 0.001f) * 1000.0) << " Mquery/s" << std::endl;
+}
+
+void print_documentation()
+{
+	std::cout << "Summed area table benchmark" << std::endl << std::endl;
+
+	std::cout << "-d, -data_dir" << std::endl;
+	std::cout << "The directory containing the data files relative to this program." << std::endl << std::endl;
+
+	std::cout << "-b, -bits" << std::endl;
+	std::cout << "Comma separated numbers of bits in the unsigned integer data types to sweep: 8, 16 or 32. The default is all three." << std::endl << std::endl;
+
+	std::cout << "-r, -repetitions" << std::endl;
+	std::cout << "How many times every generator is timed for each input. The minimum, median and 99th percentile are reported." << std::endl << std::endl;
+
+	std::cout << "-w, -warmup" << std::endl;
+	std::cout << "How many untimed runs of every generator precede the timed ones. The default is " << DEFAULT_BENCHMARK_WARMUP << "." << std::endl << std::endl;
+
+	std::cout << "-sz, -sizes" << std::endl;
+	std::cout << "Comma separated sides of the square synthetic inputs added to the data files. The default is 4096,8192." << std::endl << std::endl;
+
+	std::cout << "-p, -patterns" << std::endl;
+	std::cout << "Comma separated patterns of the synthetic inputs:";
+	for (const std::string& name : SyntheticInput::pattern_names())
+	{
+		std::cout << " " << name;
+	}
+	std::cout << ". The default is random." << std::endl << std::endl;
+
+	std::cout << "-go, -generators_only" << std::endl;
+	std::cout << "Only time the generators, skipping the query, update, cache, batch, multi-channel, volume, statistics and loading benchmarks." << std::endl << std::endl;
+
+	std::cout << "-pc, -perf_counters" << std::endl;
+	std::cout << "Count cycles, instructions, last level cache misses and branch misses of the generators with perf_event_open on Linux." << std::endl;
+	std::cout << "The IPC and the misses per run are printed. The JSON file gets the counts of every phase, and the CSV file" << std::endl;
+	std::cout << "the mean counts of a run summed over all its phases." << std::endl << std::endl;
+
+	std::cout << "-json" << std::endl;
+	std::cout << "Write the generator timings of every type to a JSON file." << std::endl << std::endl;
+
+	std::cout << "-csv" << std::endl;
+	std::cout << "Write the generator timings of every type to a CSV file." << std::endl << std::endl;
+
+	std::cout << "-q, -queries" << std::endl;
+	std::cout << "The number of random box sum queries run against the table of every input." << std::endl << std::endl;
+}
+
+// Split a comma separated list like "4096,8192"
+std::vector<std::string> split_list(const std::string& text)
+{
+	std::vector<std::string> items;
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ','))
+	{
+		items.push_back(item);
+	}
+	if (items.empty())
+	{
+		throw std::runtime_error("Expected a comma separated list, got \"" + text + "\"");
+	}
+	return items;
+}
+
+std::vector<int> parse_int_list(const std::string& text)
+{
+	std::vector<int> values;
+	for (const std::string& item : split_list(text))
+	{
+		values.push_back(std::stoi(item));
+	}
+	return values;
+}
+
+// Benchmark every generator on every input with the data type T and add the timings to the report
+template <typename T>
+void run_benchmarks(const BenchmarkOptions& options, BenchmarkReport& report)
+{
+	const std::string& data_directory = options.data_directory;
+	int repetitions = options.repetitions;
+	std::vector<std::string> data_files = { "twos_128_x_128.txt", "twos_256_x_256.txt", "twos_1024_x_1024.txt" };
+	std::vector<BenchmarkInput<T>> inputs;
+	for (const std::string& file : data_files)
+	{
+		BenchmarkInput<T> input;
+		input.name = file;
+		InputParser::parse_input_file(data_directory + "/" + file, input.data, 0);
+		inputs.push_back(std::move(input));
+	}
+	for (SyntheticPattern pattern : options.patterns)
+	{
+		for (int size : options.sizes)
+		{
+			BenchmarkInput<T> input;
+			input.name = SyntheticInput::pattern_name(pattern) + "_" + std::to_string(size) + "_x_" + std::to_string(size);
+			SyntheticInput::generate(SyntheticInputSettings{ pattern, size, size }, input.data, 0);
+			inputs.push_back(std::move(input));
+		}
+	}
+
+	// Every CPU generator with default settings, the reference first, and a sweep of tile sizes
+	std::vector<BenchmarkGenerator<T>> generators;
+	for (const std::string& name : SummedAreaTableGeneratorFactory::cpu_generator_names())
+	{
+		generators.push_back({ SummedAreaTableGeneratorFactory::display_name(name),
+			SummedAreaTableGeneratorFactory::create_cpu_generator<T>(name, CpuGeneratorSettings{}) });
+	}
+	for (int tile_size : { 64, 128, 512 })
+	{
+		generators.push_back({ "CPU Tiled " + std::to_string(tile_size), std::make_unique<SummedAreaTableGeneratorCpuTiledImpl<T>>(tile_size, tile_size) });
+	}
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << std::endl << DATA_NUM_OF_BITS<T> << " bit data, " << options.warmup << " warmup and " << repetitions << " timed runs" << std::endl;
+	std::cout << std::left << std::setw(28) << "Input" << std::setw(20) << "Generator"
+		<< std::right << std::setw(10) << "Min (ms)" << std::setw(13) << "Median (ms)" << std::setw(10) << "P99 (ms)"
+		<< std::setw(12) << "Mpixel/s" << std::setw(10) << "GB/s" << std::setw(10) << "Speedup";
+	if (PerformanceCounters::active() != nullptr)
+	{
+		std::cout << std::setw(8) << "IPC" << std::setw(16) << "LLC misses" << std::setw(16) << "Branch misses";
+	}
+	std::cout << std::endl;
+
+	std::vector<DataContainer<T>> reference_outputs;
+	for (const BenchmarkInput<T>& input : inputs)
+	{
+		DataContainer<T> reference_output;
+		float reference_time = 0.0f;
+
+		for (BenchmarkGenerator<T>& generator : generators)
+		{
+			DataContainer<T> output;
+			BenchmarkResult result;
+			result.input = input.name;
+			result.generator = generator.name;
+			result.num_of_bits = DATA_NUM_OF_BITS<T>;
+			result.width = input.data.width;
+			result.height = input.data.height;
+			result.warmup = options.warmup;
+			result.repetitions = repetitions;
+			result.time = measure_generator(*generator.generator, input.data, output, options.warmup, repetitions, &result.phases);
+			float time = result.time.median;
+
+			if (reference_output.data.empty())
+			{
+				reference_output = std::move(output);
+				reference_time = time;
+			}
+			else if (output.data != reference_output.data)
+			{
+				throw std::runtime_error(generator.name + " output doesn't match the reference for " + input.name);
+			}
+
+			std::cout << std::left << std::setw(28) << input.name << std::setw(20) << generator.name
+				<< std::right << std::setw(10) << result.time.min << std::setw(13) << result.time.median << std::setw(10) << result.time.p99
+				<< std::setw(12) << result.mpixels_per_second() << std::setw(10) << result.gigabytes_per_second()
+				<< std::setw(9) << reference_time / std::max(time, 0.001f) << "x";
+			if (result.phases.has_counters())
+			{
+				CounterValues counters = result.phases.total_counters();
+				std::cout << std::setw(8) << counters.ipc() << std::setw(16) << counters.llc_misses << std::setw(16) << counters.branch_misses;
+			}
+			std::cout << std::endl;
+			report.add(result);
+		}
+		reference_outputs.push_back(std::move(reference_output));
+	}
+
+	if (options.generators_only)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < inputs.size() && options.query_count > 0; ++i)
+	{
+		run_query_benchmarks(inputs[i].name, reference_outputs[i], options.query_count, repetitions);
+	}
+
+	run_update_benchmarks(inputs.back().name, inputs.back().data, reference_outputs.back(), repetitions);
+	run_fenwick_benchmarks(inputs, repetitions);
+	run_out_of_core_benchmark(inputs.back().name, inputs.back().data, reference_outputs.back(), repetitions);
+
+	run_cache_benchmark(inputs.back().name, inputs.back().data, reference_outputs.back(), repetitions);
+	run_batch_benchmark<T>(repetitions);
+	run_multi_channel_benchmark<T>(repetitions);
+	run_volume_benchmark<T>(options.query_count, repetitions);
+	run_statistics_benchmark(inputs.back().name, inputs.back().data, options.query_count, repetitions);
+
+	size_t last_file = data_files.size() - 1;
+	run_load_benchmark(data_directory + "/" + data_files[last_file], inputs[last_file].name, reference_outputs[last_file], repetitions);
+}
+
+int main(int argument_count, char* arguments[])
+{
+	try
+	{
+		BenchmarkOptions options;
+
+		for (int i = 1; i < argument_count; ++i)
+		{
+			std::string argument = arguments[i];
+			bool has_value = i + 1 < argument_count;
+
+			if ((argument == "-d" || argument == "-data_dir") && has_value)
+			{
+				options.data_directory = arguments[++i];
+			}
+			else if ((argument == "-b" || argument == "-bits") && has_value)
+			{
+				options.num_of_bits = parse_int_list(arguments[++i]);
+			}
+			else if ((argument == "-r" || argument == "-repetitions") && has_value)
+			{
+				options.repetitions = std::max(1, std::stoi(arguments[++i]));
+			}
+			else if ((argument == "-w" || argument == "-warmup") && has_value)
+			{
+				options.warmup = std::max(0, std::stoi(arguments[++i]));
+			}
+			else if ((argument == "-q" || argument == "-queries") && has_value)
+			{
+				options.query_count = std::max(0, std::stoi(arguments[++i]));
+			}
+			else if ((argument == "-sz" || argument == "-sizes") && has_value)
+			{
+				options.sizes = parse_int_list(arguments[++i]);
+			}
+			else if ((argument == "-p" || argument == "-patterns") && has_value)
+			{
+				options.patterns.clear();
+				for (const std::string& name : split_list(arguments[++i]))
+				{
+					options.patterns.push_back(SyntheticInput::parse_pattern(name));
+				}
+			}
+			else if (argument == "-go" || argument == "-generators_only")
+			{
+				options.generators_only = true;
+			}
+			else if (argument == "-pc" || argument == "-perf_counters")
+			{
+				options.performance_counters = true;
+			}
+			else if (argument == "-json" && has_value)
+			{
+				options.json_file = arguments[++i];
+			}
+			else if (argument == "-csv" && has_value)
+			{
+				options.csv_file = arguments[++i];
+			}
+			else if (argument == "-h" || argument == "-help")
+			{
+				print_documentation();
+				return 0;
+			}
+		}
+
+		std::unique_ptr<PerformanceCounters> performance_counters;
+		if (options.performance_counters)
+		{
+			performance_counters = std::make_unique<PerformanceCounters>();
+			if (!performance_counters->available())
+			{
+				std::cout << "Performance counters are unavailable: " << performance_counters->unavailable_reason() << std::endl;
+			}
+		}
+		ActivePerformanceCounters active_performance_counters(performance_counters.get());
+
+		BenchmarkReport report;
+		for (int num_of_bits : options.num_of_bits)
+		{
+			dispatch_data_type(num_of_bits, [&](auto type_tag)
+			{
+				run_benchmarks<decltype(type_tag)>(options, report);
+			});
+		}
+
+		if (!options.json_file.empty())
+		{
+			report.write_json(options.json_file);
+			std::cout << std::endl << "Wrote the generator timings to " << options.json_file << std::endl;
+		}
+		if (!options.csv_file.empty())
+		{
+			report.write_csv(options.csv_file);
+			std::cout << std::endl << "Wrote the generator timings to " << options.csv_file << std::endl;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
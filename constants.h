@@ -2,30 +2,37 @@
 
 #include <cstdint>
 #include <cmath>
+#include <limits>
 #include <string>
 
-// The data type used
-// NOTE: If changing to 32 bits, overflow isn't currently handled in the compute shaders!
-typedef uint8_t data_t;
+// The data type is selected at runtime (-bits). Everything working on the data
+// is a template instantiated for uint8_t, uint16_t and uint32_t
+// NOTE: With 32 bits, overflow isn't currently handled in the compute shaders!
+static const int DEFAULT_DATA_NUM_OF_BITS = 8;
 
-// Data properties (updated automatically)
-static const int DATA_NUM_OF_BITS = sizeof(data_t) * 8;
-static const uint64_t DATA_MAX_VALUE = std::pow(2, DATA_NUM_OF_BITS) - 1;
-static const int DATA_MAX_STRING_LENGTH = std::to_string(DATA_MAX_VALUE).length();
+// Data properties of the data type T (updated automatically)
+template <typename T>
+inline constexpr int DATA_NUM_OF_BITS = sizeof(T) * 8;
+template <typename T>
+inline constexpr uint64_t DATA_MAX_VALUE = std::numeric_limits<T>::max();
+template <typename T>
+inline const int DATA_MAX_STRING_LENGTH = static_cast<int>(std::to_string(DATA_MAX_VALUE<T>).length());
 
 // Standard console width is 80 symbols. For larger data we will include a 
 // 7 character ellipsis at the end of the line. Calculate how much data fits.
 // Height maximum is the same for symmetry
 static const int PRINT_TARGET_CONSOLE_WIDTH = 80;
 static const int PRINT_ELLIPSIS_SIZE = 7;
-static const int PRINT_MAX_WIDTH = std::floor((PRINT_TARGET_CONSOLE_WIDTH - PRINT_ELLIPSIS_SIZE)
-											/ (float)DATA_MAX_STRING_LENGTH);
-static const int PRINT_MAX_HEIGHT = PRINT_MAX_WIDTH;
+template <typename T>
+inline const int PRINT_MAX_WIDTH = static_cast<int>(std::floor((PRINT_TARGET_CONSOLE_WIDTH - PRINT_ELLIPSIS_SIZE)
+											/ (float)DATA_MAX_STRING_LENGTH<T>));
+template <typename T>
+inline const int PRINT_MAX_HEIGHT = PRINT_MAX_WIDTH<T>;
 
-// Limit the input size
-static const int INPUT_DATA_MAX_WIDTH = 2048;
-static const int INPUT_DATA_MAX_HEIGHT = 2048;
+// Limit the input size to a fraction of the physical memory, leaving room for the tables generated from it
+static const int INPUT_DATA_MEMORY_FRACTION = 4;
 
 // Default values when not given command line arguments
 static const std::string DEFAULT_INPUT_FILE = "data/square_10_x_10.txt";
-static const std::string DEFAULT_SHADER_DIRECTORY = "shaders";
\ No newline at end of file
+static const std::string DEFAULT_SHADER_DIRECTORY = "shaders";
+static const int DEFAULT_CACHE_SIZE_MB = 1024;
\ No newline at end of file
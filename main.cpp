@@ -1,30 +1,42 @@
 #include <iostream>
+#include <algorithm>
 #include <chrono>
+#include <fstream>
+#include <memory>
+#include <random>
 #include <stdexcept>
 
+#include "BinaryDataFile.h"
 #include "DataContainer.h"
 #include "InputParser.h"
+#include "PerformanceCounters.h"
 #include "SummedAreaTableGenerator.h"
-#include "SummedAreaTableGeneratorCpuImpl.h"
+#include "SummedAreaTableGeneratorCached.h"
+#include "SummedAreaTableGeneratorFactory.h"
 #include "SummedAreaTableGeneratorGpuImpl.h"
+#include "SummedAreaTableQuery.h"
+#include "SummedAreaTableStreamGenerator.h"
+#include "SyntheticInput.h"
+#include "TimingReport.h"
 #include "constants.h"
 #include "DirectXHelper.h"
 
-void print_data(DataContainer& data)
+template <typename T>
+void print_data(DataContainer<T>& data)
 {
 	int width = data.width;
 	int height = data.height;
 
-	bool width_limited = width > PRINT_MAX_WIDTH;
-	bool height_limited = height > PRINT_MAX_HEIGHT;
+	bool width_limited = width > PRINT_MAX_WIDTH<T>;
+	bool height_limited = height > PRINT_MAX_HEIGHT<T>;
 
 	if (width_limited)
 	{
-		width = PRINT_MAX_WIDTH;
+		width = PRINT_MAX_WIDTH<T>;
 	}
 	if (height_limited)
 	{
-		height = PRINT_MAX_HEIGHT;
+		height = PRINT_MAX_HEIGHT<T>;
 	}
 
 	std::string token;
@@ -32,11 +44,11 @@ void print_data(DataContainer& data)
 	{
 		for (int x = 0; x < width; ++x)
 		{
-			token = std::to_string(data.data[y*data.width + x]);
+			token = std::to_string(data.data[static_cast<size_t>(y) * data.width + x]);
 
 			// Pad with spaces to separate data and align rows. 
 			// Adding the spaces one by one is inefficient, but it doesn't really matter here
-			while (token.length() <= DATA_MAX_STRING_LENGTH)
+			while (token.length() <= DATA_MAX_STRING_LENGTH<T>)
 			{
 				token += " ";
 			}
@@ -53,8 +65,8 @@ void print_data(DataContainer& data)
 	if (height_limited)
 	{
 		std::string dot_token;
-		dot_token.resize(DATA_MAX_STRING_LENGTH + 1, ' ');
-		dot_token[std::floor(DATA_MAX_STRING_LENGTH / 2)] = '.';
+		dot_token.resize(DATA_MAX_STRING_LENGTH<T> + 1, ' ');
+		dot_token[std::floor(DATA_MAX_STRING_LENGTH<T> / 2)] = '.';
 
 		// Add 3 columns of dots for indicating hidden data
 		for (int y = 0; y < 3; ++y)
@@ -71,37 +83,164 @@ void print_data(DataContainer& data)
 	std::cout << std::endl;
 }
 
-// Compare the CPU and GPU data and check that they match, and print statistics
-void compare_data(DataContainer& cpu_data, DataContainer& gpu_data, float cpu_time, float gpu_time)
+// Print which of two durations in nanoseconds was faster and by how much
+void print_speed_ratio(const std::string& reference_name, int64_t reference_time, const std::string& name, int64_t time, const std::string& what)
 {
-	size_t data_size = cpu_data.data.size();
+	// Count at least a nanosecond, so the ratio is defined
+	double speed_ratio = static_cast<double>(std::max<int64_t>(reference_time, 1)) / std::max<int64_t>(time, 1);
+	if (speed_ratio > 1)
+	{
+		std::cout << name << " " << what << " was " << speed_ratio << "x faster!" << std::endl;
+	}
+	else
+	{
+		std::cout << reference_name << " " << what << " was " << 1.0 / speed_ratio << "x faster!" << std::endl;
+	}
+}
+
+// Compare the output data of two generators and check that they match, and print statistics
+// The speed ratio covers every phase of the generators, from allocating the output to reading it back
+template <typename T>
+void compare_data(const std::string& reference_name, DataContainer<T>& reference_data, const TimingReport& reference_timing,
+	const std::string& name, DataContainer<T>& data, const TimingReport& timing)
+{
+	size_t data_size = reference_data.data.size();
 
-	if (gpu_data.data.size() != data_size)
+	if (data.data.size() != data_size)
 	{
-		std::cout << "GPU and CPU output data size doesn't match!" << std::endl;
+		std::cout << name << " and " << reference_name << " output data size doesn't match!" << std::endl;
 		return;
 	}
 
 	for (size_t i = 0; i < data_size; i++)
 	{
-		if (cpu_data.data[i] != gpu_data.data[i])
+		if (reference_data.data[i] != data.data[i])
 		{
-			std::cout << "GPU and CPU output data doesn't match!" << std::endl;
+			std::cout << name << " and " << reference_name << " output data doesn't match!" << std::endl;
 			return;
 		}
 	}
 
-	std::cout << "GPU and CPU output data matches!" << std::endl;
+	std::cout << name << " and " << reference_name << " output data matches!" << std::endl;
 
-	float speed_ratio = cpu_time / gpu_time;
-	if (speed_ratio > 1)
+	print_speed_ratio(reference_name, reference_timing.total(), name, timing.total(), "generation");
+	// A cache hit doesn't compute anything
+	if (reference_timing.phase(TIMING_PHASE_COMPUTE) > 0 && timing.phase(TIMING_PHASE_COMPUTE) > 0)
+	{
+		print_speed_ratio(reference_name, reference_timing.phase(TIMING_PHASE_COMPUTE), name, timing.phase(TIMING_PHASE_COMPUTE), "compute phase");
+	}
+}
+
+// Check that box sums queried from the summed area table match the sums of the input values in
+// random boxes. With OverflowMode::Wrap every box whose true sum fits in the data type must be
+// exact. With OverflowMode::Saturate only boxes whose bottom right corner isn't clamped
+template <typename T>
+void verify_box_sums(const std::string& name, const DataContainer<T>& input_data, const DataContainer<T>& output_data, OverflowMode mode)
+{
+	static const int BOX_COUNT = 1000;
+	static const int BOX_MAX_SIZE = 32;
+
+	if (input_data.data.empty())
+	{
+		return;
+	}
+
+	std::mt19937 random(0);
+	std::vector<QueryRectangle> boxes;
+	std::vector<uint64_t> exact_sums;
+
+	for (int i = 0; i < BOX_COUNT; ++i)
+	{
+		QueryRectangle box;
+		box.x = random() % input_data.width;
+		box.y = random() % input_data.height;
+		box.width = std::min<int>(1 + random() % BOX_MAX_SIZE, input_data.width - box.x);
+		box.height = std::min<int>(1 + random() % BOX_MAX_SIZE, input_data.height - box.y);
+
+		uint64_t exact_sum = 0;
+		for (int y = box.y; y < box.y + box.height; ++y)
+		{
+			for (int x = box.x; x < box.x + box.width; ++x)
+			{
+				exact_sum += input_data.data[static_cast<size_t>(y) * input_data.width + x];
+			}
+		}
+
+		size_t corner = static_cast<size_t>(box.y + box.height - 1) * output_data.width + box.x + box.width - 1;
+		bool corner_clamped = mode == OverflowMode::Saturate && output_data.data[corner] == DATA_MAX_VALUE<T>;
+		if (exact_sum > DATA_MAX_VALUE<T> || corner_clamped)
+		{
+			continue; // The box sum can't be represented in the table
+		}
+
+		boxes.push_back(box);
+		exact_sums.push_back(exact_sum);
+	}
+
+	std::vector<T> box_sums;
+	SummedAreaTableQuery<T>(output_data).box_sums(boxes, box_sums);
+
+	size_t mismatching_boxes = 0;
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		if (box_sums[i] != exact_sums[i])
+		{
+			++mismatching_boxes;
+		}
+	}
+
+	if (mismatching_boxes > 0)
 	{
-		std::cout << "GPU generation was " << speed_ratio << "x faster!" << std::endl;
+		std::cout << mismatching_boxes << " of " << boxes.size() << " box sums from the " << name << " output don't match the input!" << std::endl;
 	}
 	else
 	{
-		std::cout << "CPU generation was " << 1.0f / speed_ratio << "x faster!" << std::endl;
+		std::cout << "All " << boxes.size() << " representable box sums from the " << name << " output match the input!" << std::endl;
+	}
+	std::cout << std::endl;
+}
+
+// Throughput of a generator in megapixels per second
+template <typename T>
+float megapixels_per_second(const DataContainer<T>& data, float time_ms)
+{
+	return static_cast<float>(data.width) * data.height / (std::max(time_ms, 0.001f) * 1000.0f);
+}
+
+// Print the time of every phase, and their hardware event counts if performance counters were active
+void print_timing(const std::string& name, const TimingReport& timing, std::ostream& stream = std::cout)
+{
+	stream << name << " phases:";
+	for (const TimingPhase& phase : timing.phases())
+	{
+		stream << " " << phase.name << " " << TimingReport::to_milliseconds(phase.nanoseconds) << "ms";
+	}
+	stream << std::endl;
+
+	for (const TimingPhase& phase : timing.phases())
+	{
+		if (phase.has_counters)
+		{
+			const CounterValues& counters = phase.counters;
+			stream << "  " << phase.name << ": " << counters.cycles << " cycles, " << counters.instructions << " instructions, IPC "
+				<< counters.ipc() << ", " << counters.llc_misses << " LLC misses, " << counters.branch_misses << " branch misses" << std::endl;
+		}
 	}
+	stream << std::endl;
+}
+
+// Generate and print the summed area table with the given generator and the time of every phase.
+// Returns the timing report of the generator
+template <typename T>
+TimingReport run_generator(const std::string& name, SummedAreaTableGenerator<T>& generator, const DataContainer<T>& input_data, DataContainer<T>& output_data)
+{
+	TimingReport timing = generator.generate(input_data, output_data);
+	float time = timing.total_milliseconds();
+	std::cout << name << " Output (generated in " << time << "ms, "
+		<< megapixels_per_second(input_data, time) << " Mpixel/s): " << std::endl;
+	print_data(output_data);
+	print_timing(name, timing);
+	return timing;
 }
 
 void print_documentation()
@@ -113,53 +252,254 @@ void print_documentation()
 
 	std::cout << "-f, -file" << std::endl;
 	std::cout << "The input text file to create the summed area table from. The text file should" << std::endl;
-	std::cout << "contain " << DATA_NUM_OF_BITS << " bit unsigned integers separated by any non-number symbol (comma, space, etc.)." << std::endl;
-	std::cout << "Every line needs to have the same number of values and the maximum size is " 
-		<< INPUT_DATA_MAX_WIDTH << " x " << INPUT_DATA_MAX_HEIGHT << "." << std::endl << std::endl;
+	std::cout << "contain unsigned integers of the selected size (see -bits) separated by any non-number symbol (comma, space, etc.)." << std::endl;
+	std::cout << "Every line needs to have the same number of values. The size is only limited by the memory:" << std::endl;
+	std::cout << "the data may take up to 1/" << INPUT_DATA_MEMORY_FRACTION << " of the physical memory of the computer." << std::endl;
+	std::cout << "Binary data files with input data are also accepted, and their header selects the data type." << std::endl << std::endl;
+
+	std::cout << "-sy, -synthetic" << std::endl;
+	std::cout << "Generate a synthetic input with this pattern instead of reading the input file:";
+	for (const std::string& name : SyntheticInput::pattern_names())
+	{
+		std::cout << " " << name;
+	}
+	std::cout << "." << std::endl << std::endl;
+
+	std::cout << "-sz, -size" << std::endl;
+	std::cout << "The size of the synthetic input as WxH, or a single number for a square. The default is "
+		<< SyntheticInputSettings{}.width << "x" << SyntheticInputSettings{}.height << "." << std::endl << std::endl;
+
+	std::cout << "-sd, -seed" << std::endl;
+	std::cout << "The seed of the random synthetic patterns. The same seed always gives the same input. The default is 0." << std::endl << std::endl;
+
+	std::cout << "-so, -synthetic_output" << std::endl;
+	std::cout << "Write the synthetic input to this file, to reproduce the run with -file. The file is a binary data file" << std::endl;
+	std::cout << "if the name ends in " << SyntheticInput::BINARY_FILE_EXTENSION << ", otherwise a text file." << std::endl << std::endl;
+
+	std::cout << "-b, -bits" << std::endl;
+	std::cout << "The number of bits in the unsigned integer data type: 8, 16 or 32. The default is " << DEFAULT_DATA_NUM_OF_BITS << "." << std::endl << std::endl;
+
+	std::cout << "-w, -wrap" << std::endl;
+	std::cout << "Store the summed area table modulo 2^bits instead of clamping the sums to the maximum value." << std::endl;
+	std::cout << "Box sums that fit in the data type stay exact when computed with unsigned wraparound." << std::endl << std::endl;
+
+	std::cout << "-st, -stream" << std::endl;
+	std::cout << "Stream the input file row by row to the output (see -output) instead of comparing the generators." << std::endl;
+	std::cout << "Only one row is kept in memory, so the input can be larger than the memory and has no size limit." << std::endl << std::endl;
+
+	std::cout << "-o, -output" << std::endl;
+	std::cout << "The text file the streamed summed area table is written to. The default is the standard output." << std::endl << std::endl;
+
+	std::cout << "-bo, -binary_output" << std::endl;
+	std::cout << "Write the summed area table of the reference CPU generator to this binary data file," << std::endl;
+	std::cout << "which can be memory mapped without parsing." << std::endl << std::endl;
+
+	std::cout << "-c, -cache" << std::endl;
+	std::cout << "Cache the summed area tables of the reference CPU generator in this directory. Running again with the same" << std::endl;
+	std::cout << "input, data type and overflow mode maps the cached table in instead of generating it." << std::endl << std::endl;
+
+	std::cout << "-cs, -cache_size" << std::endl;
+	std::cout << "The maximum size of the cache in megabytes. The least recently used tables are removed to stay below it. The default is "
+		<< DEFAULT_CACHE_SIZE_MB << "." << std::endl << std::endl;
+
+	std::cout << "-g, -generator" << std::endl;
+	std::cout << "The CPU generator to compare against the reference CPU generator, or all of them with \"all\" (the default)." << std::endl;
+	std::cout << "Available generators:";
+	for (const std::string& name : SummedAreaTableGeneratorFactory::cpu_generator_names())
+	{
+		std::cout << " " << name;
+	}
+	std::cout << std::endl << std::endl;
+
+	std::cout << "-pc, -perf_counters" << std::endl;
+	std::cout << "Count cycles, instructions, last level cache misses and branch misses of every phase of the parser and the generators." << std::endl;
+	std::cout << "Uses the Linux perf_event_open system call and needs /proc/sys/kernel/perf_event_paranoid to be 2 or less." << std::endl << std::endl;
+
+	std::cout << "-t, -threads" << std::endl;
+	std::cout << "The number of threads used by the parallel CPU generator and for parsing large input files. The default 0 uses every hardware thread." << std::endl << std::endl;
+
+	std::cout << "-ts, -tile_size" << std::endl;
+	std::cout << "The tile width and height in elements for the tiled CPU generator. The default is "
+		<< CpuGeneratorSettings{}.tile_size << "." << std::endl << std::endl;
+}
+
+// Parse the input, generate the summed area tables with the data type T and compare them
+template <typename T>
+void run(const CommandLineOptions& options)
+{
+	// With performance counters every phase timer reports them, in the parser and the generators
+	std::unique_ptr<PerformanceCounters> performance_counters;
+	if (options.performance_counters)
+	{
+		performance_counters = std::make_unique<PerformanceCounters>();
+		if (!performance_counters->available())
+		{
+			std::cout << "Performance counters are unavailable: " << performance_counters->unavailable_reason() << std::endl << std::endl;
+		}
+	}
+	ActivePerformanceCounters active_performance_counters(performance_counters.get());
+
+	DataContainer<T> input_data;
+	std::string input_name = "Input";
+	TimingReport input_timing;
+	PhaseTimer input_timer(input_timing);
+	if (options.synthetic)
+	{
+		SyntheticInput::generate(options.synthetic_settings, input_data, options.generator_settings.thread_count);
+		input_timer.lap("synthesize");
+		input_name = "Synthetic " + SyntheticInput::pattern_name(options.synthetic_settings.pattern) + " input";
+		if (!options.synthetic_output_file.empty())
+		{
+			SyntheticInput::write_file(options.synthetic_output_file, input_data);
+			std::cout << "Wrote the synthetic input to " << options.synthetic_output_file << std::endl << std::endl;
+		}
+	}
+	else
+	{
+		InputParser::parse_input_file(options.input_file, input_data, options.generator_settings.thread_count);
+		input_timer.lap("parse");
+	}
+
+	std::cout.precision(3);
+
+	std::cout << input_name << " (" << input_data.width << " x " << input_data.height << ", "
+		<< DATA_NUM_OF_BITS<T> << " bit, " << overflow_mode_name(options.generator_settings.overflow_mode) << " mode): " << std::endl;
+	print_data(input_data);
+	print_timing("Input", input_timing);
+
+	// Generate and print the summed area table with the reference CPU generator
+	const std::vector<std::string>& cpu_generator_names = SummedAreaTableGeneratorFactory::cpu_generator_names();
+	const std::string& reference_name = cpu_generator_names.front();
+	DataContainer<T> cpu_output_data;
+	std::unique_ptr<SummedAreaTableGenerator<T>> cpu_generator = SummedAreaTableGeneratorFactory::create_cpu_generator<T>(reference_name, options.generator_settings);
+
+	// With a cache the reference table is mapped in from an earlier run when there is one
+	std::unique_ptr<SummedAreaTableCache> cache;
+	if (!options.cache_directory.empty())
+	{
+		cache = std::make_unique<SummedAreaTableCache>(options.cache_directory, static_cast<uint64_t>(options.cache_size_mb) * 1024 * 1024);
+		cpu_generator = std::make_unique<SummedAreaTableGeneratorCached<T>>(std::move(cpu_generator), reference_name, *cache);
+		cpu_generator->set_overflow_mode(options.generator_settings.overflow_mode);
+	}
+
+	TimingReport cpu_timing = run_generator("CPU", *cpu_generator, input_data, cpu_output_data);
+	if (cache)
+	{
+		const CacheStatistics& statistics = cache->statistics();
+		std::cout << "Cache " << (statistics.hits > 0 ? "hit" : "miss") << " in " << options.cache_directory << " (" << statistics.hits << " hits, "
+			<< statistics.misses << " misses, " << statistics.evictions << " evictions, " << cache->size() / (1024 * 1024) << " MB used)" << std::endl << std::endl;
+	}
+	verify_box_sums("CPU", input_data, cpu_output_data, options.generator_settings.overflow_mode);
+
+	if (!options.binary_output_file.empty())
+	{
+		BinaryDataFile::write(options.binary_output_file, cpu_output_data, BinaryPayload::SummedAreaTable);
+		std::cout << "Wrote the summed area table to " << options.binary_output_file << std::endl << std::endl;
+	}
+
+	// Generate the summed area table with the selected CPU generators and check them against the reference
+	for (const std::string& name : cpu_generator_names)
+	{
+		if (name == reference_name || (options.cpu_generator != "all" && options.cpu_generator != name))
+		{
+			continue;
+		}
+
+		std::string display_name = SummedAreaTableGeneratorFactory::display_name(name);
+		DataContainer<T> output_data;
+		std::unique_ptr<SummedAreaTableGenerator<T>> generator = SummedAreaTableGeneratorFactory::create_cpu_generator<T>(name, options.generator_settings);
+		TimingReport timing = run_generator(display_name, *generator, input_data, output_data);
+		compare_data("CPU", cpu_output_data, cpu_timing, display_name, output_data, timing);
+		std::cout << std::endl;
+	}
+
+	// Generate and print the summed area table on the GPU, if the input fits in a texture
+	if (input_data.width > SummedAreaTableGeneratorGpuImpl<T>::MAX_TEXTURE_DIMENSION || input_data.height > SummedAreaTableGeneratorGpuImpl<T>::MAX_TEXTURE_DIMENSION)
+	{
+		std::cout << "Skipping the GPU, as the input is larger than the maximum texture size of " << SummedAreaTableGeneratorGpuImpl<T>::MAX_TEXTURE_DIMENSION
+			<< " x " << SummedAreaTableGeneratorGpuImpl<T>::MAX_TEXTURE_DIMENSION << std::endl;
+		return;
+	}
+	DataContainer<T> gpu_output_data;
+	SummedAreaTableGeneratorGpuImpl<T> gpu_generator;
+	gpu_generator.set_overflow_mode(options.generator_settings.overflow_mode);
+	TimingReport gpu_timing = run_generator("GPU", gpu_generator, input_data, gpu_output_data);
+
+	compare_data("CPU", cpu_output_data, cpu_timing, "GPU", gpu_output_data, gpu_timing);
+}
+
+// Stream the summed area table of the input file to the output file or the standard output.
+// Status messages go to the standard error, so they don't mix with the table
+template <typename T>
+void run_stream(const CommandLineOptions& options)
+{
+	InputRowReader<T> reader(options.input_file, std::cerr);
+	SummedAreaTableStreamGenerator<T> generator;
+	generator.set_overflow_mode(options.generator_settings.overflow_mode);
+
+	TimingReport timing;
+	if (options.output_file.empty())
+	{
+		timing = generator.generate(reader, std::cout);
+	}
+	else
+	{
+		std::ofstream output_file(options.output_file, std::ios::binary);
+		if (!output_file)
+		{
+			throw std::runtime_error("Could not open output file: " + options.output_file);
+		}
+		timing = generator.generate(reader, output_file);
+	}
+
+	std::cerr << "Streamed the " << reader.width() << " x " << reader.rows_read() << " summed area table ("
+		<< DATA_NUM_OF_BITS<T> << " bit, " << overflow_mode_name(options.generator_settings.overflow_mode) << " mode) in "
+		<< timing.total_milliseconds() << "ms" << std::endl;
+	print_timing("Stream", timing, std::cerr);
 }
 
 int main(int argument_count, char* arguments[])
 {
 	try
 	{
-		std::string input_file;
-		std::string shader_directory;
-		bool print_help;
-		InputParser::parse_command_line_arguments(argument_count, arguments, input_file, shader_directory, print_help);
+		CommandLineOptions options;
+		InputParser::parse_command_line_arguments(argument_count, arguments, options);
 
-		if (print_help)
+		if (options.print_help)
 		{
 			print_documentation();
 			return 0;
 		}
 
-		DirectXHelper::init(shader_directory);
-
-		std::cout << "Summed area table utility. Type -h or -help for documentation." << std::endl << std::endl;
-
-		DataContainer input_data;
-		InputParser::parse_input_file(input_file, input_data);
-
-		std::cout.precision(3);
+		// Binary input files know their data type
+		bool binary_input = !options.synthetic && BinaryDataFile::is_binary_file(options.input_file);
+		if (binary_input)
+		{
+			options.data_num_of_bits = static_cast<int>(BinaryDataFile::read_header(options.input_file).num_of_bits);
+		}
 
-		std::cout << "Input (" << input_data.width << " x " << input_data.height << "): " << std::endl;
-		print_data(input_data);
+		if (options.stream)
+		{
+			if (binary_input || options.synthetic)
+			{
+				throw std::runtime_error("The streaming mode needs a text input file");
+			}
+			dispatch_data_type(options.data_num_of_bits, [&](auto type_tag)
+			{
+				run_stream<decltype(type_tag)>(options);
+			});
+			return 0;
+		}
 
-		// Generate and print the summed area table on the CPU
-		DataContainer cpu_output_data;
-		SummedAreaTableGeneratorCpuImpl cpu_generator;
-		float cpu_time = cpu_generator.generate(input_data, cpu_output_data);
-		std::cout << "CPU Output (generated in " << cpu_time << "ms): " << std::endl;
-		print_data(cpu_output_data);
+		DirectXHelper::init(options.shader_directory);
 
-		// Generate and print the summed area table on the GPU
-		DataContainer gpu_output_data;
-		SummedAreaTableGeneratorGpuImpl gpu_generator;
-		float gpu_time = gpu_generator.generate(input_data, gpu_output_data);
-		std::cout << "GPU Output (generated in " << gpu_time << "ms): " << std::endl;
-		print_data(gpu_output_data);
+		std::cout << "Summed area table utility. Type -h or -help for documentation." << std::endl << std::endl;
 
-		compare_data(cpu_output_data, gpu_output_data, cpu_time, gpu_time);
+		// Every data type gets its own instantiation of the parser and generators
+		dispatch_data_type(options.data_num_of_bits, [&](auto type_tag)
+		{
+			run<decltype(type_tag)>(options);
+		});
 	}
 	catch (std::runtime_error e)
 	{
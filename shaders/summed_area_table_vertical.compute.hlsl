@@ -3,6 +3,8 @@ RWTexture2D<uint> summed_area_table : register(u1);
 struct DataProperties
 {
     uint max_value;
+    // When nonzero, store the sums modulo 2^bits instead of clamping them to max_value
+    uint wrap;
 };
 
 ConstantBuffer<DataProperties> data_properties : register(b1, space0);
@@ -26,6 +28,11 @@ void main(uint3 dispatchThreadID : SV_DispatchThreadID)
     {
         index.y = i;
         current_sum += summed_area_table[index];
+        if (data_properties.wrap != 0)
+        {
+            // max_value is 2^bits - 1, so masking is the same as modulo 2^bits
+            current_sum &= data_properties.max_value;
+        }
         summed_area_table[index] = min(current_sum, data_properties.max_value);
     }
 }
\ No newline at end of file